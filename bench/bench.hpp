@@ -0,0 +1,94 @@
+#ifndef __BENCH_HPP__
+#define __BENCH_HPP__
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//Minimal self-contained timing harness shared by the benchmarks.
+namespace bench{
+
+    using clock = std::chrono::steady_clock;
+
+    template<typename F>
+    double measure(F &&f){
+        auto beg = clock::now();
+        f();
+        auto end = clock::now();
+        return std::chrono::duration<double, std::milli>(end - beg).count();
+    }
+
+    template<typename T>
+    void do_not_optimize(const T &val){
+        asm volatile("" : : "r,m"(val) : "memory");
+    }
+
+    //reports go to out as one JSON array instead of the text table when set
+    struct json_sink{
+        std::FILE *out = nullptr;
+        bool first = true;
+
+        ~json_sink(){
+            if(!out)
+                return;
+            std::fputs(first ? "[]\n" : "\n]\n", out);
+            if(out != stdout)
+                std::fclose(out);
+        }
+    };
+
+    inline json_sink &json(){
+        static json_sink sink;
+        return sink;
+    }
+
+    //The first plain argument is the problem size. --json switches the reports to JSON
+    //on stdout, --json=path writes them to path.
+    inline unsigned long long arg_size(int argc, char *argv[], unsigned long long dft){
+        bool sized = false;
+        for(int i=1; i<argc; ++i){
+            if(!std::strncmp(argv[i], "--json", 6)){
+                if(!json().out)
+                    json().out = argv[i][6] == '=' ? std::fopen(argv[i] + 7, "w") : stdout;
+                if(!json().out){
+                    std::fprintf(stderr, "cannot open %s\n", argv[i] + 7);
+                    std::exit(1);
+                }
+            }
+            else if(!sized){
+                dft = std::strtoull(argv[i], nullptr, 10);
+                sized = true;
+            }
+        }
+        return dft;
+    }
+
+    inline void report(const char *name, const char *subject, unsigned long long n, double ms){
+        auto &sink = json();
+        if(!sink.out){
+            std::printf("%-24s %-24s n=%-12llu %12.3f ms\n", name, subject, n, ms);
+            return;
+        }
+
+        //names are plain text, but keep the output valid JSON for any of them
+        auto quoted = [&sink](const char *str){
+            std::fputc('"', sink.out);
+            for(; *str; ++str){
+                if(*str == '"' || *str == '\\')
+                    std::fputc('\\', sink.out);
+                std::fputc(*str, sink.out);
+            }
+            std::fputc('"', sink.out);
+        };
+        std::fputs(sink.first ? "[\n  {\"name\": " : ",\n  {\"name\": ", sink.out);
+        quoted(name);
+        std::fputs(", \"subject\": ", sink.out);
+        quoted(subject);
+        std::fprintf(sink.out, ", \"n\": %llu, \"ms\": %.6f}", n, ms);
+        sink.first = false;
+    }
+
+}   //!bench
+
+#endif  //!__BENCH_HPP__
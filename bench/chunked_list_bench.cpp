@@ -0,0 +1,57 @@
+#include "efficient_list.hpp"
+#include "chunked_list.hpp"
+#include "bench.hpp"
+#include <malloc.h>
+#include <random>
+#include <vector>
+
+namespace{
+
+std::size_t heap_in_use(){
+    auto mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+}
+
+template<typename List>
+void run(const char *subject, unsigned long long n){
+    std::default_random_engine de(42);
+    std::vector<unsigned long long> pos(n), idx(n);
+    for(unsigned long long i=0; i<n; ++i){
+        pos[i] = std::uniform_int_distribution<unsigned long long>(0, i)(de);
+        idx[i] = std::uniform_int_distribution<unsigned long long>(0, n-1)(de);
+    }
+
+    auto before = heap_in_use();
+    List lst;
+    bench::report("insert(random)", subject, n, bench::measure([&]{
+        for(unsigned long long i=0; i<n; ++i)
+            lst.insert(pos[i], int(i));
+    }));
+    std::printf("%-24s %-24s n=%-12llu %12.2f bytes/elem\n", "memory", subject, n, double(heap_in_use() - before) / n);
+
+    long long sum = 0;
+    bench::report("read(random)", subject, n, bench::measure([&]{
+        for(auto i : idx)
+            sum += lst[i];
+    }));
+
+    bench::report("scan", subject, n, bench::measure([&]{
+        for(auto v : lst)
+            sum += v;
+    }));
+
+    bench::report("erase(random)", subject, n, bench::measure([&]{
+        for(unsigned long long i=n; i>0; --i)
+            lst.erase(pos[i-1]);
+    }));
+    bench::do_not_optimize(sum);
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    run<stl::he_list<int>>("he_list", n);
+    run<stl::chunked_list<int>>("chunked_list", n);
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "efficient_list.hpp"
+#include "concurrent_list.hpp"
+#include "bench.hpp"
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace{
+
+constexpr auto duration = std::chrono::milliseconds(500);
+
+//a he_list behind one mutex, the baseline
+struct locked_list{
+    stl::he_list<int> lst;
+    std::mutex mtx;
+
+    explicit locked_list(unsigned long long n):lst(n, 1) { }
+
+    void write(std::default_random_engine &de){
+        std::lock_guard<std::mutex> lk(mtx);
+        auto pos = de() % lst.size();
+        lst.erase(pos);
+        lst.insert(pos, int(de()));
+    }
+
+    template<typename Reader>
+    long long reads(Reader &, std::default_random_engine &de, int batch){
+        long long sum = 0;
+        std::lock_guard<std::mutex> lk(mtx);
+        for(int i=0; i<batch; ++i)
+            sum += lst[de() % lst.size()];
+        return sum;
+    }
+
+    int make_reader(){
+        return 0;
+    }
+};
+
+struct rcu_list{
+    stl::concurrent_list<int> lst;
+
+    explicit rcu_list(unsigned long long n):lst(stl::persistent_list<int>(n, 1)) { }
+
+    void write(std::default_random_engine &de){
+        lst.update([&](stl::persistent_list<int> &v){
+            auto pos = de() % v.size();
+            v.erase(pos);
+            v.insert(pos, int(de()));
+        });
+    }
+
+    template<typename Reader>
+    long long reads(Reader &rd, std::default_random_engine &de, int batch){
+        long long sum = 0;
+        auto v = rd.pin();
+        for(int i=0; i<batch; ++i)
+            sum += v[de() % v->size()];
+        return sum;
+    }
+
+    stl::concurrent_list<int>::reader make_reader(){
+        return lst.make_reader();
+    }
+};
+
+//random reads per second with one writer running all the time
+template<typename List>
+void run(const char *subject, unsigned long long n, unsigned threads){
+    List lst(n);
+    std::atomic<bool> stop{false};
+    std::atomic<long long> total{0};
+    std::vector<std::thread> readers;
+    for(unsigned t=0; t<threads; ++t){
+        readers.emplace_back([&, t]{
+            std::default_random_engine de(t);
+            auto rd = lst.make_reader();
+            long long cnt = 0, sum = 0;
+            while(!stop.load(std::memory_order_relaxed)){
+                sum += lst.reads(rd, de, 64);
+                cnt += 64;
+            }
+            bench::do_not_optimize(sum);
+            total += cnt;
+        });
+    }
+
+    std::default_random_engine de(42);
+    long long writes = 0;
+    auto beg = bench::clock::now();
+    while(bench::clock::now() - beg < duration){
+        lst.write(de);
+        ++writes;
+    }
+    stop = true;
+    for(auto &t : readers)
+        t.join();
+
+    auto secs = std::chrono::duration<double>(bench::clock::now() - beg).count();
+    std::printf("%-24s readers=%-3u n=%-12llu %12.0f reads/s %10.0f writes/s\n",
+                subject, threads, n, total / secs, writes / secs);
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 100000);
+    auto hw = std::thread::hardware_concurrency();
+    for(unsigned t=1; t<=(hw < 2 ? 2 : hw); t*=2){
+        run<locked_list>("mutex he_list", n, t);
+        run<rcu_list>("concurrent_list", n, t);
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+//he_list against the standard sequence containers at sizes 1e3, 1e4, ... up to the
+//size given on the command line. Operations whose cost is linear per call on a
+//container (random access in std::list, push_front on std::vector) are skipped once
+//they would take minutes; missing entries in the report mean "not measured".
+namespace{
+
+//random-position operations per size, and the container sizes they stay affordable up to
+constexpr unsigned long long random_ops = 1000;
+constexpr unsigned long long random_reads = 1000000;
+constexpr unsigned long long linear_limit = 1000000;
+constexpr unsigned long long quadratic_limit = 100000;
+
+std::default_random_engine de(42);
+
+template<typename C>
+typename C::iterator at(C &c, unsigned long long pos){
+    return std::next(c.begin(), pos);
+}
+
+template<typename C>
+void insert_at(C &c, unsigned long long pos, int val){
+    c.insert(at(c, pos), val);
+}
+
+template<typename T, typename A, typename G, typename S>
+void insert_at(stl::he_list<T, A, G, S> &c, unsigned long long pos, int val){
+    c.insert(pos, val);
+}
+
+template<typename C>
+void erase_at(C &c, unsigned long long pos){
+    c.erase(at(c, pos));
+}
+
+template<typename T, typename A, typename G, typename S>
+void erase_at(stl::he_list<T, A, G, S> &c, unsigned long long pos){
+    c.erase(pos);
+}
+
+template<typename C>
+int read_at(C &c, unsigned long long pos){
+    return *at(c, pos);
+}
+
+template<typename T>
+int read_at(std::vector<T> &c, unsigned long long pos){
+    return c[pos];
+}
+
+template<typename T>
+int read_at(std::deque<T> &c, unsigned long long pos){
+    return c[pos];
+}
+
+template<typename T, typename A, typename G, typename S>
+int read_at(stl::he_list<T, A, G, S> &c, unsigned long long pos){
+    return c[pos];
+}
+
+template<typename C>
+void push_front(C &c, int val){
+    c.push_front(val);
+}
+
+template<typename T>
+void push_front(std::vector<T> &c, int val){
+    c.insert(c.begin(), val);
+}
+
+template<typename C>
+void run(const char *subject, unsigned long long n, bool random_access, bool cheap_front){
+    long long sum = 0;
+    auto pos_in = [](unsigned long long sz){
+        return std::uniform_int_distribution<unsigned long long>(0, sz)(de);
+    };
+
+    C *c = nullptr;
+    bench::report("push_back", subject, n, bench::measure([&]{
+        c = new C;
+        for(unsigned long long i=0; i<n; ++i)
+            c->push_back(int(i));
+    }));
+
+    bench::report("iterate", subject, n, bench::measure([&]{
+        for(auto v : *c)
+            sum += v;
+    }));
+
+    if(random_access || n <= linear_limit){
+        auto reads = random_access ? std::min(n, random_reads) : random_ops;
+        std::string name = "read(random) x" + std::to_string(reads);
+        bench::report(name.c_str(), subject, n, bench::measure([&]{
+            for(unsigned long long i=0; i<reads; ++i)
+                sum += read_at(*c, pos_in(n-1));
+        }));
+
+        name = "insert(random) x" + std::to_string(random_ops);
+        bench::report(name.c_str(), subject, n, bench::measure([&]{
+            for(unsigned long long i=0; i<random_ops; ++i)
+                insert_at(*c, pos_in(n+i), int(i));
+        }));
+
+        name = "erase(random) x" + std::to_string(random_ops);
+        bench::report(name.c_str(), subject, n, bench::measure([&]{
+            for(unsigned long long i=random_ops; i>0; --i)
+                erase_at(*c, pos_in(n+i-1));
+        }));
+    }
+
+    C *copied = nullptr;
+    bench::report("copy", subject, n, bench::measure([&]{
+        copied = new C(*c);
+    }));
+    bench::report("destroy", subject, n, bench::measure([&]{
+        delete copied;
+    }));
+    delete c;
+
+    if(cheap_front || n <= quadratic_limit){
+        C front;
+        bench::report("push_front", subject, n, bench::measure([&]{
+            for(unsigned long long i=0; i<n; ++i)
+                push_front(front, int(i));
+        }));
+    }
+    bench::do_not_optimize(sum);
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto max_n = bench::arg_size(argc, argv, 1000000);
+    for(unsigned long long n=1000; n<=max_n; n*=10){
+        run<stl::he_list<int>>("he_list", n, true, true);
+        run<std::vector<int>>("std::vector", n, true, false);
+        run<std::deque<int>>("std::deque", n, true, true);
+        run<std::list<int>>("std::list", n, false, true);
+    }
+    return 0;
+}
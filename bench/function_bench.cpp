@@ -0,0 +1,148 @@
+#include "functional.hpp"
+#include "bench.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace{
+
+//callable capturing N bytes (N = 0: a captureless lambda)
+template<std::size_t N>
+struct capture{
+    long long data[N / sizeof(long long)];
+
+    long long operator()(long long x){
+        return data[0] + x;
+    }
+};
+
+template<>
+struct capture<0>{
+    long long operator()(long long x){
+        return x + 1;
+    }
+};
+
+template<typename Fn, std::size_t N>
+void run(const char *subject, unsigned long long n){
+    auto tag = std::string(subject) + "/" + std::to_string(N) + "B";
+    capture<N> c{};
+    //both vectors are filled once up front, so that page faults stay out of the numbers
+    std::vector<Fn> fns(n), copies(n);
+    fns.clear();
+    copies.clear();
+    bench::report("construct", tag.c_str(), n, bench::measure([&]{
+        for(unsigned long long i=0; i<n; ++i)
+            fns.emplace_back(c);
+    }));
+
+    bench::report("copy", tag.c_str(), n, bench::measure([&]{
+        for(auto &f : fns)
+            copies.push_back(f);
+    }));
+
+    long long sum = 0;
+    bench::report("call", tag.c_str(), n, bench::measure([&]{
+        for(auto &f : fns)
+            sum += f(1);
+    }));
+    bench::report("destroy", tag.c_str(), n, bench::measure([&]{
+        fns.clear();
+        copies.clear();
+    }));
+    bench::do_not_optimize(sum);
+}
+
+template<std::size_t N>
+void run_all(unsigned long long n){
+    run<std::function<long long(long long)>, N>("std::function", n);
+    run<stl::function<long long(long long)>, N>("stl::function", n);
+    run<stl::function<long long(long long), 64>, N>("stl::function<64>", n);
+    run<stl::inplace_function<long long(long long), 64>, N>("stl::inplace<64>", n);
+}
+
+//Task queue of callables owning a unique_ptr: std::function needs the state wrapped
+//in a shared_ptr, unique_function takes the move-only lambda as it is.
+template<typename Fn, typename Wrap>
+void run_tasks(const char *subject, unsigned long long n, Wrap wrap){
+    std::vector<Fn> queue(n);
+    queue.clear();
+    bench::report("enqueue", subject, n, bench::measure([&]{
+        for(unsigned long long i=0; i<n; ++i)
+            queue.push_back(wrap(std::make_unique<long long>(i)));
+    }));
+
+    long long sum = 0;
+    bench::report("run+destroy", subject, n, bench::measure([&]{
+        for(auto &f : queue)
+            sum += f(1);
+        queue.clear();
+    }));
+    bench::do_not_optimize(sum);
+}
+
+//Callback parameter of an API, called count times during the call. The callees are
+//kept out of line so that the callback cannot be inlined into the caller.
+template<typename F>
+__attribute__((noinline)) long long each_template(unsigned long long count, F &&f){
+    long long sum = 0;
+    for(unsigned long long i=0; i<count; ++i)
+        sum += f(i);
+    return sum;
+}
+
+__attribute__((noinline)) long long each_ref(unsigned long long count, stl::function_ref<long long(long long)> f){
+    long long sum = 0;
+    for(unsigned long long i=0; i<count; ++i)
+        sum += f(i);
+    return sum;
+}
+
+__attribute__((noinline)) long long each_function(unsigned long long count, stl::function<long long(long long)> f){
+    long long sum = 0;
+    for(unsigned long long i=0; i<count; ++i)
+        sum += f(i);
+    return sum;
+}
+
+//"call": one API call invoking the callback n times, "pass": n API calls invoking it once,
+//so that constructing the parameter is part of the cost
+template<typename Each>
+void run_callback(const char *subject, unsigned long long n, Each each){
+    capture<32> c{};
+    long long sum = 0;
+    bench::report("call", subject, n, bench::measure([&]{
+        sum += each(n, [&c](long long x){ return c(x); });
+    }));
+    bench::report("pass", subject, n, bench::measure([&]{
+        for(unsigned long long i=0; i<n; ++i)
+            sum += each(1, [c](long long x)mutable{ return c(x); });
+    }));
+    bench::do_not_optimize(sum);
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    run_all<0>(n);
+    run_all<8>(n);
+    run_all<16>(n);
+    run_all<24>(n);
+    run_all<32>(n);
+    run_all<48>(n);
+    run_all<64>(n);
+
+    run_callback("template", n, [](unsigned long long count, auto &&f){ return each_template(count, f); });
+    run_callback("stl::function_ref", n, [](unsigned long long count, auto &&f){ return each_ref(count, f); });
+    run_callback("stl::function", n, [](unsigned long long count, auto &&f){ return each_function(count, f); });
+
+    run_tasks<std::function<long long(long long)>>("std::function+shared_ptr", n, [](std::unique_ptr<long long> p){
+        return [s = std::shared_ptr<long long>(std::move(p))](long long x){ return *s + x; };
+    });
+    run_tasks<stl::unique_function<long long(long long)>>("stl::unique_function", n, [](std::unique_ptr<long long> p){
+        return [p = std::move(p)](long long x){ return *p + x; };
+    });
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace{
+
+template<typename List>
+void run(const char *subject, unsigned long long n){
+    std::default_random_engine de(42);
+    std::vector<unsigned long long> pos(n);
+    for(unsigned long long i=0; i<n; ++i)
+        pos[i] = std::uniform_int_distribution<unsigned long long>(0, i)(de);
+
+    {
+        List *lst = nullptr;
+        bench::report("push_back", subject, n, bench::measure([&]{
+            lst = new List;
+            for(unsigned long long i=0; i<n; ++i)
+                lst->push_back(int(i));
+        }));
+        bench::report("destroy", subject, n, bench::measure([&]{
+            delete lst;
+        }));
+    }
+
+    List lst;
+    bench::report("insert(random)", subject, n, bench::measure([&]{
+        for(unsigned long long i=0; i<n; ++i)
+            lst.insert(pos[i], int(i));
+    }));
+
+    bench::report("erase(random)", subject, n, bench::measure([&]{
+        for(unsigned long long i=n; i>0; --i)
+            lst.erase(pos[i-1]);
+    }));
+    bench::do_not_optimize(lst.size());
+
+    for(int keep=0; keep<2; ++keep){
+        bench::report(keep ? "refill x5 clear(true)" : "refill x5 clear()", subject, n, bench::measure([&]{
+            for(int r=0; r<5; ++r){
+                for(unsigned long long i=0; i<n; ++i)
+                    lst.push_back(int(i));
+                lst.clear(keep);
+            }
+        }));
+    }
+
+    for(unsigned long long i=0; i<n; ++i)
+        lst.push_back(int(i));
+    auto k = n / 2;
+    bench::report("erase k=n/2 one by one", subject, n, bench::measure([&]{
+        for(unsigned long long i=0; i<k; ++i)
+            lst.erase(n / 4);
+    }));
+    for(unsigned long long i=0; i<k; ++i)
+        lst.insert(n / 4, int(i));
+    bench::report("erase(first, last) k=n/2", subject, n, bench::measure([&]{
+        lst.erase(n / 4, n / 4 + k);
+    }));
+    bench::do_not_optimize(lst.size());
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    run<stl::he_list<int>>("node_pool", n);
+    run<stl::he_list<int, std::allocator<int>>>("std::allocator", n);
+    run<stl::he_list<int, stl::node_pool<int>, stl::he_list_plain, stl::he_list_counting>>("node_pool+counting", n);
+    return 0;
+}
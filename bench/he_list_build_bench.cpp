@@ -0,0 +1,46 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <numeric>
+#include <vector>
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    std::vector<int> src(n);
+    std::iota(src.begin(), src.end(), 0);
+
+    bench::report("build", "push_back loop", n, bench::measure([&]{
+        stl::he_list<int> lst;
+        for(auto v : src)
+            lst.push_back(v);
+        bench::do_not_optimize(lst.size());
+    }));
+
+    bench::report("build", "range constructor", n, bench::measure([&]{
+        stl::he_list<int> lst(src.begin(), src.end());
+        bench::do_not_optimize(lst.size());
+    }));
+
+    bench::report("build", "append_range x16", n, bench::measure([&]{
+        stl::he_list<int> lst;
+        auto step = n / 16 + 1;
+        for(unsigned long long i=0; i<n; i+=step)
+            lst.append_range(src.begin() + i, src.begin() + std::min(n, i+step));
+        bench::do_not_optimize(lst.size());
+    }));
+
+    stl::he_list<int> base(src.begin(), src.end());
+    auto k = n / 10;
+    auto lst1 = base, lst2 = base;
+    bench::report("insert k=n/10 at n/2", "insert loop", n, bench::measure([&]{
+        for(unsigned long long i=0; i<k; ++i)
+            lst1.insert(n/2 + i, src[i]);
+        bench::do_not_optimize(lst1.size());
+    }));
+
+    bench::report("insert k=n/10 at n/2", "insert range", n, bench::measure([&]{
+        lst2.insert(n/2, src.begin(), src.begin() + k);
+        bench::do_not_optimize(lst2.size());
+    }));
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <numeric>
+#include <random>
+#include <vector>
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    std::vector<int> src(n);
+    std::iota(src.begin(), src.end(), 0);
+    stl::he_list<int> lst(src.begin(), src.end());
+
+    std::default_random_engine de(42);
+    std::vector<unsigned long long> local(n);
+    unsigned long long p = 0;
+    for(auto &v : local){
+        p = std::min<unsigned long long>(n-1, p + de() % 4);
+        v = p;
+    }
+
+    long long sum = 0;
+    bench::report("sequential read", "operator[]", n, bench::measure([&]{
+        for(unsigned long long i=0; i<n; ++i)
+            sum += lst[i];
+    }));
+
+    bench::report("sequential read", "cursor", n, bench::measure([&]{
+        auto cur = lst.cursor_at(0);
+        for(unsigned long long i=0; i<n; ++i)
+            sum += cur[i];
+    }));
+
+    bench::report("local read (+0..3)", "operator[]", n, bench::measure([&]{
+        for(auto i : local)
+            sum += lst[i];
+    }));
+
+    bench::report("local read (+0..3)", "cursor", n, bench::measure([&]{
+        auto cur = lst.cursor_at(0);
+        for(auto i : local)
+            sum += cur[i];
+    }));
+
+    bench::report("insert every 2nd", "insert(pos)", n/2, bench::measure([&]{
+        for(unsigned long long i=0; i<n/2; ++i)
+            lst.insert(2*i, -1);
+    }));
+
+    bench::report("erase every 2nd", "cursor", n/2, bench::measure([&]{
+        auto cur = lst.cursor_at(0);
+        for(unsigned long long i=0; i<n/2; ++i){
+            cur.erase();
+            ++cur;
+        }
+    }));
+
+    bench::do_not_optimize(sum);
+    return 0;
+}
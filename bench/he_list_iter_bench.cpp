@@ -0,0 +1,58 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    std::vector<int> src(n);
+    std::iota(src.begin(), src.end(), 0);
+    stl::he_list<int> lst(src.begin(), src.end());
+
+    long long sum = 0;
+    bench::report("traverse", "range-for", n, bench::measure([&]{
+        for(auto v : lst)
+            sum += v;
+    }));
+
+    bench::report("traverse", "post-increment", n, bench::measure([&]{
+        for(auto it = lst.cbegin(); it != lst.cend(); it++)
+            sum += *it;
+    }));
+
+    bench::report("traverse", "begin() x n/100", n, bench::measure([&]{
+        for(unsigned long long i=0; i<n/100; ++i)
+            sum += *lst.begin();
+    }));
+    bench::report("traverse", "reverse", n, bench::measure([&]{
+        for(auto it = lst.end(); it != lst.begin(); )
+            sum += *--it;
+    }));
+
+    std::vector<unsigned long long> pos(n);
+    for(unsigned long long i=0; i<n; ++i)
+        pos[i] = i * 2654435761u % n;
+    bench::report("operator[] random", "he_list", n, bench::measure([&]{
+        for(auto p : pos)
+            sum += lst[p];
+    }));
+
+    stl::frozen_list<int> frozen;
+    bench::report("freeze", "he_list", n, bench::measure([&]{
+        frozen = lst.freeze();
+    }));
+    bench::report("operator[] random", "frozen_list", n, bench::measure([&]{
+        for(auto p : pos)
+            sum += frozen[p];
+    }));
+    bench::report("traverse", "frozen_list", n, bench::measure([&]{
+        for(auto v : frozen)
+            sum += v;
+    }));
+    bench::report("thaw", "he_list", n, bench::measure([&]{
+        lst.thaw(std::move(frozen));
+    }));
+    bench::do_not_optimize(sum);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace{
+
+template<typename List>
+void run(const char *subject, unsigned long long n, unsigned threads){
+    std::vector<std::string> init;
+    for(unsigned long long i=0; i<n; ++i)
+        init.push_back("element " + std::to_string(i));
+    List lst(init.begin(), init.end());
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s/%u threads", subject, threads);
+    bench::report("for_each", name, n, bench::measure([&]{
+        lst.for_each([](std::string &val){ val[0] ^= 1; }, threads);
+    }));
+
+    stl::he_list<long long, typename List::allocator_type::template rebind<long long>::other> nums(n, 1);
+    long long total = 0;
+    bench::report("reduce(sum)", name, n, bench::measure([&]{
+        total = nums.reduce(0LL, [](long long a, long long b){ return a + b; }, threads);
+    }));
+    bench::do_not_optimize(total);
+
+    bench::report("copy_to", name, n, bench::measure([&]{
+        lst.copy_to(init.begin(), threads);
+    }));
+}
+
+//copies and teardown always use every hardware thread
+template<typename List>
+void run_copy(const char *subject, unsigned long long n){
+    std::vector<std::string> init;
+    for(unsigned long long i=0; i<n; ++i)
+        init.push_back("element " + std::to_string(i));
+    List lst(init.begin(), init.end());
+
+    List *copied = nullptr;
+    bench::report("copy", subject, n, bench::measure([&]{
+        copied = new List(lst);
+    }));
+    bench::report("destroy", subject, n, bench::measure([&]{
+        delete copied;
+    }));
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    auto hw = std::thread::hardware_concurrency();
+    for(unsigned t=1; ; t=hw){
+        run<stl::he_list<std::string>>("node_pool", n, t);
+        run<stl::he_list<std::string, std::allocator<std::string>>>("std::allocator", n, t);
+        if(t >= hw)
+            break;
+    }
+    run_copy<stl::he_list<std::string>>("node_pool", n);
+    run_copy<stl::he_list<std::string, std::allocator<std::string>>>("std::allocator", n);
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace{
+
+//Every search scans the whole list: the probe is absent and the extremum is unique.
+//A built list has its nodes in memory in order, random inserts scatter them.
+template<typename T>
+void run(const char *subject, unsigned long long n, bool scattered){
+    std::default_random_engine de(42);
+    std::vector<T> src(n);
+    for(auto &v : src)
+        v = T(de() % 1000000);
+    src[n / 2] = T(2000000);
+    stl::he_list<T> lst;
+    if(scattered){
+        for(unsigned long long i=0; i<n; ++i)
+            lst.insert(std::uniform_int_distribution<unsigned long long>(0, i)(de), src[i]);
+    }
+    else{
+        lst.assign(src.begin(), src.end());
+    }
+    const T absent = T(-1);
+
+    unsigned long long sum = 0;
+    bench::report("std::find", subject, n, bench::measure([&]{
+        sum += std::find(lst.begin(), lst.end(), absent) == lst.end();
+    }));
+    bench::report("index_of", subject, n, bench::measure([&]{
+        sum += lst.index_of(absent);
+    }));
+    bench::report("std::count", subject, n, bench::measure([&]{
+        sum += std::count(lst.begin(), lst.end(), src[0]);
+    }));
+    bench::report("count", subject, n, bench::measure([&]{
+        sum += lst.count(src[0]);
+    }));
+    bench::report("std::max_element", subject, n, bench::measure([&]{
+        sum += std::max_element(lst.begin(), lst.end()) - lst.begin();
+    }));
+    bench::report("max_element", subject, n, bench::measure([&]{
+        sum += lst.max_element() - lst.begin();
+    }));
+    bench::do_not_optimize(sum);
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    run<int>("int built", n, false);
+    run<int>("int scattered", n, true);
+    run<double>("double built", n, false);
+    run<double>("double scattered", n, true);
+    return 0;
+}
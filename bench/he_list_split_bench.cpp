@@ -0,0 +1,34 @@
+#include "efficient_list.hpp"
+#include "bench.hpp"
+#include <random>
+
+//The time of a split at a random position and the concat that undoes it should grow
+//with log n only, so the rows for growing n stay close together.
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    const int rounds = 10000;
+    std::default_random_engine de(20251231);
+
+    for(auto size = n / 64; size <= n; size *= 4){
+        stl::he_list<int> lst(size, 1);
+        std::uniform_int_distribution<unsigned long long> at(0, size);
+        bench::report("split + concat x10000", "node_pool", size, bench::measure([&]{
+            for(int i=0; i<rounds; ++i){
+                auto tail = lst.split(at(de));
+                lst.concat(std::move(tail));
+            }
+            bench::do_not_optimize(lst.size());
+        }));
+
+        stl::he_list<int, std::allocator<int>> global(size, 1);
+        bench::report("split + concat x10000", "std::allocator", size, bench::measure([&]{
+            for(int i=0; i<rounds; ++i){
+                auto tail = global.split(at(de));
+                global.concat(std::move(tail));
+            }
+            bench::do_not_optimize(global.size());
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "list_file.hpp"
+#include "bench.hpp"
+#include <cstdio>
+
+namespace{
+
+const char *path = "list_file_bench.bin";
+
+//the old way: read the elements back one at a time and push_back each
+stl::he_list<long long> load_by_push_back(){
+    stl::he_list<long long> lst;
+    std::FILE *f = std::fopen(path, "rb");
+    stl::list_file_header h;
+    if(std::fread(&h, sizeof(h), 1, f) == 1){
+        long long val;
+        while(std::fread(&val, sizeof(val), 1, f) == 1)
+            lst.push_back(val);
+    }
+    std::fclose(f);
+    return lst;
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 10000000);
+    stl::he_list<long long> lst;
+    for(unsigned long long i=0; i<n; ++i)
+        lst.push_back((long long)(i * 2654435761u));
+
+    bench::report("save_list", "he_list", n, bench::measure([&]{
+        stl::save_list(lst, path);
+    }));
+    bench::report("fread+push_back", "he_list", n, bench::measure([&]{
+        bench::do_not_optimize(load_by_push_back().size());
+    }));
+    bench::report("load_list", "he_list", n, bench::measure([&]{
+        bench::do_not_optimize(stl::load_list<long long>(path).size());
+    }));
+
+    long long sum = 0;
+    bench::report("map+scan", "mapped_list", n, bench::measure([&]{
+        stl::mapped_list<long long> view(path);
+        for(auto v : view)
+            sum += v;
+    }));
+    bench::report("map+random [] x1e6", "mapped_list", n, bench::measure([&]{
+        stl::mapped_list<long long> view(path);
+        for(unsigned long long i=0; i<1000000; ++i)
+            sum += view[i * 7919 % n];
+    }));
+    bench::do_not_optimize(sum);
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "efficient_list.hpp"
+#include "persistent_list.hpp"
+#include "bench.hpp"
+#include <random>
+#include <vector>
+
+namespace{
+
+//every tick changes a few elements and keeps a snapshot of the list for readers
+template<typename List>
+void run(const char *subject, unsigned long long n, int ticks, int writes){
+    std::default_random_engine de(42);
+    std::vector<int> init(n);
+    for(auto &v : init)
+        v = int(de());
+    List lst(init.begin(), init.end());
+
+    std::vector<List> snapshots;
+    bench::report("snapshot+write/tick", subject, n, bench::measure([&]{
+        for(int t=0; t<ticks; ++t){
+            for(int w=0; w<writes; ++w){
+                auto pos = std::uniform_int_distribution<unsigned long long>(0, n-1)(de);
+                lst.erase(pos);
+                lst.insert(pos, t);
+            }
+            snapshots.push_back(lst);
+        }
+    }) / ticks);
+
+    long long sum = 0;
+    bench::report("read snapshot", subject, n, bench::measure([&]{
+        for(auto v : snapshots.back())
+            sum += v;
+    }));
+    bench::report("drop snapshots", subject, n, bench::measure([&]{
+        snapshots.clear();
+    }));
+    bench::do_not_optimize(sum);
+}
+
+}
+
+int main(int argc, char *argv[]){
+    auto n = bench::arg_size(argc, argv, 1000000);
+    run<stl::he_list<int>>("he_list", n, 20, 100);
+    run<stl::persistent_list<int>>("persistent_list", n, 20, 100);
+    return 0;
+}
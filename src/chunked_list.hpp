@@ -0,0 +1,694 @@
+#ifndef __CHUNKED_LIST_HPP__
+#define __CHUNKED_LIST_HPP__
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace stl{
+
+    inline namespace version_0{
+
+
+        template<typename T, std::size_t BlockSize, bool Const> class chunked_list_iterator;
+
+        template<typename T>
+        struct chunked_list_block{
+            static constexpr std::size_t value = 512 / sizeof(T) < 16 ? 16 : 512 / sizeof(T);
+        };
+
+        //Indexed sequence with the interface of he_list, stored as a counted B+ tree.
+        //Leaves hold up to BlockSize contiguous elements and are chained for linear scans,
+        //inner nodes hold per-child element counts. Lookup, insert and erase are O(log n)
+        //but touch a handful of cache lines, and the per-element overhead is a few bytes.
+        template<typename T, std::size_t BlockSize = chunked_list_block<T>::value>
+        class chunked_list{
+            static_assert(BlockSize >= 4, "BlockSize must hold at least 4 elements.");
+
+            friend class chunked_list_iterator<T, BlockSize, false>;
+            friend class chunked_list_iterator<T, BlockSize, true>;
+
+        public:
+            using value_type = T;
+            using size_t = unsigned long long;
+            using iterator = chunked_list_iterator<T, BlockSize, false>;
+            using const_iterator = chunked_list_iterator<T, BlockSize, true>;
+
+            static constexpr std::size_t block_size = BlockSize;
+            static constexpr std::size_t fanout = 64;
+
+        private:
+            struct leaf{
+                leaf *prev = nullptr;
+                leaf *next = nullptr;
+                std::size_t count = 0;
+                alignas(T) unsigned char storage[BlockSize * sizeof(T)];
+
+                T *data(){
+                    return reinterpret_cast<T*>(storage);
+                }
+
+                const T *data()const{
+                    return reinterpret_cast<const T*>(storage);
+                }
+            };
+
+            struct inner{
+                std::size_t count = 0;
+                size_t sizes[fanout];
+                void *children[fanout];
+            };
+
+            struct step{
+                inner *nd;
+                std::size_t idx;
+            };
+
+            //fanout/4 minimum fill bounds the height far below this for any 64-bit size
+            static constexpr unsigned max_height = 40;
+
+        public:
+            chunked_list():root(nullptr), height(0), total(0), first(nullptr), last(nullptr){ }
+
+            chunked_list(size_t n, const value_type &value = value_type{}):
+                chunked_list(){
+                for(size_t i=0; i<n; ++i)
+                    push_back(value);
+            }
+
+            template<typename V>
+            chunked_list(std::initializer_list<V> lst):
+                chunked_list(){
+                for(auto &val : lst)
+                    push_back(val);
+            }
+
+            template<typename Iterator, typename = std::enable_if_t<
+                                        std::is_convertible<
+                                                typename std::iterator_traits<Iterator>::iterator_category,
+                                                std::input_iterator_tag
+                                                    >::value
+                                                                    >
+                    >
+            chunked_list(Iterator beg, Iterator end):
+                chunked_list(){
+                for(; beg != end; ++beg)
+                    push_back(*beg);
+            }
+
+            chunked_list(const chunked_list &rhs):
+                chunked_list(rhs.begin(), rhs.end()){
+            }
+
+            chunked_list(chunked_list &&rhs)noexcept:
+                root(rhs.root), height(rhs.height), total(rhs.total), first(rhs.first), last(rhs.last){
+                rhs.root = nullptr;
+                rhs.height = 0;
+                rhs.total = 0;
+                rhs.first = rhs.last = nullptr;
+            }
+
+            ~chunked_list(){
+                free_mem();
+            }
+
+            chunked_list &operator=(const chunked_list &rhs){
+                chunked_list tmp(rhs);
+                return operator=(std::move(tmp));
+            }
+
+            chunked_list &operator=(chunked_list &&rhs)noexcept{
+                if(this != &rhs){
+                    free_mem();
+                    std::swap(root, rhs.root);
+                    std::swap(height, rhs.height);
+                    std::swap(total, rhs.total);
+                    std::swap(first, rhs.first);
+                    std::swap(last, rhs.last);
+                }
+
+                return *this;
+            }
+
+        public:
+            size_t size()const{
+                return total;
+            }
+
+            bool empty()const{
+                return !total;
+            }
+
+            void clear(){
+                free_mem();
+            }
+
+        public:
+            void insert(size_t pos, const value_type &val){
+                check(pos, total+1);
+                insert_at(pos, val);
+            }
+
+            void insert(size_t pos, value_type &&val){
+                check(pos, total+1);
+                insert_at(pos, std::move(val));
+            }
+
+            void erase(size_t pos){
+                check(pos, total);
+                erase_at(pos);
+            }
+
+            void push_back(const value_type &val){
+                insert_at(total, val);
+            }
+
+            void push_back(value_type &&val){
+                insert_at(total, std::move(val));
+            }
+
+            void pop_back(){
+                check(0, total);
+                erase_at(total-1);
+            }
+
+            void push_front(const value_type &val){
+                insert_at(0, val);
+            }
+
+            void push_front(value_type &&val){
+                insert_at(0, std::move(val));
+            }
+
+            void pop_front(){
+                check(0, total);
+                erase_at(0);
+            }
+
+        public:
+            value_type &operator[](size_t pos){
+                check(pos, total);
+                std::size_t idx;
+                auto lf = search(pos, idx);
+                return lf->data()[idx];
+            }
+
+            const value_type &operator[](size_t pos)const{
+                check(pos, total);
+                std::size_t idx;
+                auto lf = search(pos, idx);
+                return lf->data()[idx];
+            }
+
+            value_type &front(){
+                check(0, total);
+                return first->data()[0];
+            }
+
+            const value_type &front()const{
+                check(0, total);
+                return first->data()[0];
+            }
+
+            value_type &back(){
+                check(0, total);
+                return last->data()[last->count-1];
+            }
+
+            const value_type &back()const{
+                check(0, total);
+                return last->data()[last->count-1];
+            }
+
+        public:
+            iterator begin(){
+                return iterator(first, 0);
+            }
+
+            iterator end(){
+                return iterator(last, last?last->count:0);
+            }
+
+            const_iterator begin()const{
+                return const_iterator(first, 0);
+            }
+
+            const_iterator end()const{
+                return const_iterator(last, last?last->count:0);
+            }
+
+            const_iterator cbegin()const{
+                return begin();
+            }
+
+            const_iterator cend()const{
+                return end();
+            }
+
+        private:
+            void check(size_t pos, size_t range)const{
+                if(pos >= range)
+                    throw std::runtime_error("Out of range.");
+            }
+
+            leaf *search(size_t pos, std::size_t &idx)const{
+                auto cur = root;
+                for(auto h = height; h; --h){
+                    auto in = static_cast<inner*>(cur);
+                    std::size_t i = 0;
+                    while(pos >= in->sizes[i]){
+                        pos -= in->sizes[i];
+                        ++i;
+                    }
+                    cur = in->children[i];
+                }
+
+                idx = pos;
+                return static_cast<leaf*>(cur);
+            }
+
+            //descend to the leaf receiving position pos, recording the path
+            leaf *descend(size_t &pos, step *path)const{
+                auto cur = root;
+                for(unsigned d=0; d<height; ++d){
+                    auto in = static_cast<inner*>(cur);
+                    std::size_t i = 0;
+                    while(i+1 < in->count && pos >= in->sizes[i]){
+                        pos -= in->sizes[i];
+                        ++i;
+                    }
+                    path[d] = {in, i};
+                    cur = in->children[i];
+                }
+                return static_cast<leaf*>(cur);
+            }
+
+            //val may refer to an element of this list, so it is taken before anything moves
+            template<typename V>
+            void insert_at(size_t pos, V &&val){
+                T tmp(std::forward<V>(val));
+                if(!root){
+                    root = first = last = new leaf;
+                    height = 0;
+                }
+
+                step path[max_height];
+                auto idx = pos;
+                auto lf = descend(idx, path);
+                if(lf->count == BlockSize){
+                    //splits are rare, simply descend again through the new shape
+                    split_leaf(lf, path);
+                    idx = pos;
+                    lf = descend(idx, path);
+                }
+
+                auto data = lf->data();
+                for(auto i = lf->count; i > idx; --i){
+                    new(data + i) T(std::move(data[i-1]));
+                    data[i-1].~T();
+                }
+                try{
+                    new(data + idx) T(std::move(tmp));
+                }
+                catch(...){
+                    for(auto i = idx; i < lf->count; ++i){
+                        new(data + i) T(std::move(data[i+1]));
+                        data[i+1].~T();
+                    }
+                    throw;
+                }
+                ++lf->count;
+                ++total;
+                for(unsigned d=0; d<height; ++d)
+                    ++path[d].nd->sizes[path[d].idx];
+            }
+
+            //move the upper half of a full leaf into a new right sibling
+            void split_leaf(leaf *lf, step *path){
+                auto nl = new leaf;
+                auto half = lf->count / 2;
+                move_elems(lf->data() + half, lf->count - half, nl->data());
+                nl->count = lf->count - half;
+                lf->count = half;
+
+                nl->prev = lf;
+                nl->next = lf->next;
+                if(lf->next)
+                    lf->next->prev = nl;
+                else
+                    last = nl;
+                lf->next = nl;
+
+                add_sibling(lf, half, nl, nl->count, path, height);
+            }
+
+            //Insert right (holding rsz elements) after left (now holding lsz) in the parent
+            //recorded at path[depth-1], splitting full parents up to the root. A split keeps
+            //the left half in place, so the entries above stay valid.
+            void add_sibling(void *left, size_t lsz, void *right, size_t rsz, step *path, unsigned depth){
+                for(;;){
+                    if(!depth){
+                        auto nr = new inner;
+                        nr->count = 2;
+                        nr->children[0] = left;
+                        nr->children[1] = right;
+                        nr->sizes[0] = lsz;
+                        nr->sizes[1] = rsz;
+                        root = nr;
+                        ++height;
+                        return;
+                    }
+
+                    auto in = path[depth-1].nd;
+                    auto i = path[depth-1].idx;
+                    in->sizes[i] = lsz;
+                    if(in->count < fanout){
+                        for(auto k = in->count; k > i+1; --k){
+                            in->sizes[k] = in->sizes[k-1];
+                            in->children[k] = in->children[k-1];
+                        }
+                        in->sizes[i+1] = rsz;
+                        in->children[i+1] = right;
+                        ++in->count;
+                        return;
+                    }
+
+                    //split the full inner node, then place the new child in its half
+                    auto ni = new inner;
+                    auto half = in->count / 2;
+                    for(auto k = half; k < in->count; ++k){
+                        ni->sizes[k-half] = in->sizes[k];
+                        ni->children[k-half] = in->children[k];
+                    }
+                    ni->count = in->count - half;
+                    in->count = half;
+
+                    auto target = in;
+                    auto ti = i;
+                    if(i >= half){
+                        target = ni;
+                        ti = i - half;
+                    }
+                    for(auto k = target->count; k > ti+1; --k){
+                        target->sizes[k] = target->sizes[k-1];
+                        target->children[k] = target->children[k-1];
+                    }
+                    target->sizes[ti+1] = rsz;
+                    target->children[ti+1] = right;
+                    ++target->count;
+
+                    left = in;
+                    lsz = sum(in);
+                    right = ni;
+                    rsz = sum(ni);
+                    --depth;
+                }
+            }
+
+            static size_t sum(const inner *in){
+                size_t s = 0;
+                for(std::size_t k=0; k<in->count; ++k)
+                    s += in->sizes[k];
+                return s;
+            }
+
+            void move_elems(T *src, std::size_t n, T *dst){
+                for(std::size_t i=0; i<n; ++i){
+                    new(dst + i) T(std::move(src[i]));
+                    src[i].~T();
+                }
+            }
+
+            void erase_at(size_t pos){
+                step path[max_height];
+                auto lf = descend(pos, path);
+                auto data = lf->data();
+                data[pos].~T();
+                for(auto i = pos; i+1 < lf->count; ++i){
+                    new(data + i) T(std::move(data[i+1]));
+                    data[i+1].~T();
+                }
+                --lf->count;
+                --total;
+                for(unsigned d=0; d<height; ++d)
+                    --path[d].nd->sizes[path[d].idx];
+
+                if(!height){
+                    if(!lf->count){
+                        delete lf;
+                        root = first = last = nullptr;
+                    }
+                    return;
+                }
+
+                if(lf->count < BlockSize/4)
+                    fix_leaf(path, height);
+            }
+
+            //the leaf below path[depth-1] became underfull: merge it with a neighbour or
+            //even out their counts
+            void fix_leaf(step *path, unsigned depth){
+                auto in = path[depth-1].nd;
+                auto i = path[depth-1].idx;
+                std::size_t li = i ? i-1 : i;
+                auto l = static_cast<leaf*>(in->children[li]), r = static_cast<leaf*>(in->children[li+1]);
+
+                if(l->count + r->count <= BlockSize){
+                    move_elems(r->data(), r->count, l->data() + l->count);
+                    l->count += r->count;
+                    l->next = r->next;
+                    if(r->next)
+                        r->next->prev = l;
+                    else
+                        last = l;
+                    delete r;
+                    remove_child(in, li);
+                    fix_inner(path, depth-1);
+                    return;
+                }
+
+                //redistribute so that both leaves are at least half full
+                auto want = (l->count + r->count) / 2;
+                if(l->count < want){
+                    auto n = want - l->count;
+                    move_elems(r->data(), n, l->data() + l->count);
+                    auto rd = r->data();
+                    for(std::size_t k=n; k<r->count; ++k){
+                        new(rd + k - n) T(std::move(rd[k]));
+                        rd[k].~T();
+                    }
+                    l->count += n;
+                    r->count -= n;
+                }
+                else{
+                    auto n = l->count - want;
+                    auto rd = r->data();
+                    for(auto k = r->count; k > 0; --k){
+                        new(rd + k - 1 + n) T(std::move(rd[k-1]));
+                        rd[k-1].~T();
+                    }
+                    move_elems(l->data() + want, n, rd);
+                    l->count -= n;
+                    r->count += n;
+                }
+                in->sizes[li] = l->count;
+                in->sizes[li+1] = r->count;
+            }
+
+            //in lost child li+1 which was merged into child li
+            void remove_child(inner *in, std::size_t li){
+                in->sizes[li] += in->sizes[li+1];
+                for(auto k = li+1; k+1 < in->count; ++k){
+                    in->sizes[k] = in->sizes[k+1];
+                    in->children[k] = in->children[k+1];
+                }
+                --in->count;
+            }
+
+            //the inner node at path depth `depth` may have become underfull
+            void fix_inner(step *path, unsigned depth){
+                auto in = depth ? static_cast<inner*>(path[depth-1].nd->children[path[depth-1].idx])
+                                : static_cast<inner*>(root);
+                if(!depth){
+                    if(in->count == 1){
+                        root = in->children[0];
+                        --height;
+                        delete in;
+                    }
+                    return;
+                }
+                if(in->count >= fanout/4)
+                    return;
+
+                auto parent = path[depth-1].nd;
+                auto i = path[depth-1].idx;
+                std::size_t li = i ? i-1 : i;
+                auto l = static_cast<inner*>(parent->children[li]), r = static_cast<inner*>(parent->children[li+1]);
+
+                if(l->count + r->count <= fanout){
+                    for(std::size_t k=0; k<r->count; ++k){
+                        l->sizes[l->count+k] = r->sizes[k];
+                        l->children[l->count+k] = r->children[k];
+                    }
+                    l->count += r->count;
+                    delete r;
+                    remove_child(parent, li);
+                    fix_inner(path, depth-1);
+                    return;
+                }
+
+                auto want = (l->count + r->count) / 2;
+                if(l->count < want){
+                    auto n = want - l->count;
+                    for(std::size_t k=0; k<n; ++k){
+                        l->sizes[l->count+k] = r->sizes[k];
+                        l->children[l->count+k] = r->children[k];
+                    }
+                    for(auto k = n; k < r->count; ++k){
+                        r->sizes[k-n] = r->sizes[k];
+                        r->children[k-n] = r->children[k];
+                    }
+                    l->count += n;
+                    r->count -= n;
+                }
+                else{
+                    auto n = l->count - want;
+                    for(auto k = r->count; k > 0; --k){
+                        r->sizes[k-1+n] = r->sizes[k-1];
+                        r->children[k-1+n] = r->children[k-1];
+                    }
+                    for(std::size_t k=0; k<n; ++k){
+                        r->sizes[k] = l->sizes[want+k];
+                        r->children[k] = l->children[want+k];
+                    }
+                    l->count -= n;
+                    r->count += n;
+                }
+                parent->sizes[li] = sum(l);
+                parent->sizes[li+1] = sum(r);
+            }
+
+            void free_mem(){
+                if(root)
+                    free_node(root, height);
+                root = nullptr;
+                height = 0;
+                total = 0;
+                first = last = nullptr;
+            }
+
+            void free_node(void *nd, unsigned h){
+                if(!h){
+                    auto lf = static_cast<leaf*>(nd);
+                    auto data = lf->data();
+                    for(std::size_t i=0; i<lf->count; ++i)
+                        data[i].~T();
+                    delete lf;
+                    return;
+                }
+
+                auto in = static_cast<inner*>(nd);
+                for(std::size_t i=0; i<in->count; ++i)
+                    free_node(in->children[i], h-1);
+                delete in;
+            }
+
+        private:
+            void *root;
+            unsigned height;
+            size_t total;
+            leaf *first;
+            leaf *last;
+        };
+
+
+        //Walks the chained leaves, so a full traversal is a linear scan of the blocks.
+        template<typename T, std::size_t BlockSize, bool Const>
+        class chunked_list_iterator{
+            template<typename V, std::size_t B> friend class chunked_list;
+            friend class chunked_list_iterator<T, BlockSize, !Const>;
+
+            using list_type = chunked_list<T, BlockSize>;
+            using leaf = typename list_type::leaf;
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T*, T*>;
+            using reference = std::conditional_t<Const, const T&, T&>;
+
+        public:
+            chunked_list_iterator():lf(nullptr), idx(0) { }
+
+            template<bool C, typename = std::enable_if_t<Const && !C>>
+            chunked_list_iterator(const chunked_list_iterator<T, BlockSize, C> &rhs):lf(rhs.lf), idx(rhs.idx) { }
+
+        public:
+            pointer operator->()const{
+                return lf->data() + idx;
+            }
+
+            reference operator*()const{
+                return lf->data()[idx];
+            }
+
+            chunked_list_iterator &operator++(){
+                if(++idx == lf->count && lf->next){
+                    lf = lf->next;
+                    idx = 0;
+                }
+                return *this;
+            }
+
+            chunked_list_iterator operator++(int){
+                auto ret = *this;
+                operator++();
+                return ret;
+            }
+
+            chunked_list_iterator &operator--(){
+                if(!idx){
+                    lf = lf->prev;
+                    idx = lf->count;
+                }
+                --idx;
+                return *this;
+            }
+
+            chunked_list_iterator operator--(int){
+                auto ret = *this;
+                operator--();
+                return ret;
+            }
+
+            friend bool operator==(const chunked_list_iterator &lhs, const chunked_list_iterator &rhs){
+                return lhs.lf == rhs.lf && lhs.idx == rhs.idx;
+            }
+
+            friend bool operator!=(const chunked_list_iterator &lhs, const chunked_list_iterator &rhs){
+                return !(lhs == rhs);
+            }
+
+        private:
+            chunked_list_iterator(leaf *l, std::size_t i):lf(l), idx(i) { }
+
+            chunked_list_iterator(const leaf *l, std::size_t i):lf(const_cast<leaf*>(l)), idx(i) { }
+
+        private:
+            leaf *lf;
+            std::size_t idx;
+        };
+
+
+    }   //!version_0
+
+
+}   //!stl
+
+
+#endif  //!__CHUNKED_LIST_HPP__
@@ -0,0 +1,257 @@
+#ifndef __CONCURRENT_LIST_HPP__
+#define __CONCURRENT_LIST_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "persistent_list.hpp"
+
+namespace stl{
+
+    inline namespace version_0{
+
+
+        //Indexed sequence for one writer thread and many lock-free reader threads.
+        //The writer changes a private persistent_list and publishes an O(1) snapshot of it
+        //after every change; readers pin the published snapshot and traverse it without
+        //locks or reference counting. A replaced snapshot is retired with the current
+        //epoch and freed once every reader that could still see it has unpinned.
+        template<typename T, typename Allocator = std::allocator<T>>
+        class concurrent_list{
+        public:
+            using value_type = T;
+            using size_t = unsigned long long;
+            using version_type = persistent_list<T, Allocator>;
+
+            class reader;
+            class pinned;
+
+            static constexpr std::size_t max_readers = 128;
+
+        private:
+            struct version{
+                version_type lst;
+                unsigned long long epoch = 0;
+                version *next = nullptr;
+
+                explicit version(const version_type &v):lst(v) { }
+            };
+
+            //epoch the reader pinned at, 0 while it is outside of a read section
+            struct alignas(64) slot{
+                std::atomic<unsigned long long> epoch{0};
+                std::atomic<bool> used{false};
+            };
+
+        public:
+            concurrent_list():
+                current(new version(working)), retired(nullptr), retired_tail(nullptr), epoch(1){
+            }
+
+            explicit concurrent_list(version_type init):
+                working(std::move(init)), current(new version(working)), retired(nullptr), retired_tail(nullptr), epoch(1){
+            }
+
+            concurrent_list(const concurrent_list &) = delete;
+            concurrent_list &operator=(const concurrent_list &) = delete;
+
+            //no reader may be registered any more
+            ~concurrent_list(){
+                delete current.load();
+                while(retired){
+                    auto nxt = retired->next;
+                    delete retired;
+                    retired = nxt;
+                }
+            }
+
+        public:
+            //register the calling thread as a reader
+            reader make_reader(){
+                for(auto &s : slots){
+                    bool expected = false;
+                    if(!s.used.load(std::memory_order_relaxed) &&
+                            s.used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                        return reader(this, &s);
+                }
+                throw std::runtime_error("Too many readers.");
+            }
+
+        public:
+            //Writer interface, to be called from a single thread. Every call publishes
+            //the result; update() applies several changes under one publication.
+            size_t size()const{
+                return working.size();
+            }
+
+            const version_type &latest()const{
+                return working;
+            }
+
+            template<typename F>
+            void update(F fn){
+                fn(working);
+                publish();
+            }
+
+            void insert(size_t pos, const value_type &val){
+                update([&](version_type &v){ v.insert(pos, val); });
+            }
+
+            void insert(size_t pos, value_type &&val){
+                update([&](version_type &v){ v.insert(pos, std::move(val)); });
+            }
+
+            void erase(size_t pos){
+                update([&](version_type &v){ v.erase(pos); });
+            }
+
+            template<typename V>
+            void set(size_t pos, V &&val){
+                update([&](version_type &v){ v.set(pos, std::forward<V>(val)); });
+            }
+
+            void push_back(const value_type &val){
+                update([&](version_type &v){ v.push_back(val); });
+            }
+
+            void push_back(value_type &&val){
+                update([&](version_type &v){ v.push_back(std::move(val)); });
+            }
+
+            void pop_back(){
+                update([](version_type &v){ v.pop_back(); });
+            }
+
+            void push_front(const value_type &val){
+                update([&](version_type &v){ v.push_front(val); });
+            }
+
+            void push_front(value_type &&val){
+                update([&](version_type &v){ v.push_front(std::move(val)); });
+            }
+
+            void pop_front(){
+                update([](version_type &v){ v.pop_front(); });
+            }
+
+        private:
+            void publish(){
+                auto old = current.exchange(new version(working), std::memory_order_seq_cst);
+                old->epoch = epoch.fetch_add(1, std::memory_order_seq_cst);
+                if(retired_tail)
+                    retired_tail->next = old;
+                else
+                    retired = old;
+                retired_tail = old;
+                reclaim();
+            }
+
+            //free the retired versions no pinned reader can still see
+            void reclaim(){
+                auto oldest = epoch.load(std::memory_order_seq_cst);
+                for(auto &s : slots){
+                    auto e = s.epoch.load(std::memory_order_seq_cst);
+                    if(e && e < oldest)
+                        oldest = e;
+                }
+
+                while(retired && retired->epoch < oldest){
+                    auto nxt = retired->next;
+                    delete retired;
+                    retired = nxt;
+                }
+                if(!retired)
+                    retired_tail = nullptr;
+            }
+
+        private:
+            version_type working;
+            std::atomic<version*> current;
+            version *retired, *retired_tail;
+            std::atomic<unsigned long long> epoch;
+            slot slots[max_readers];
+        };
+
+
+        //Handle of one reader thread, it must not be shared between threads.
+        template<typename T, typename Allocator>
+        class concurrent_list<T, Allocator>::reader{
+            friend class concurrent_list;
+
+        public:
+            reader(reader &&rhs)noexcept:lst(rhs.lst), s(rhs.s){
+                rhs.s = nullptr;
+            }
+
+            reader(const reader &) = delete;
+            reader &operator=(const reader &) = delete;
+
+            ~reader(){
+                if(s)
+                    s->used.store(false, std::memory_order_release);
+            }
+
+            //pin the latest published version for the lifetime of the returned guard
+            pinned pin()const{
+                s->epoch.store(lst->epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+                return pinned(s, &lst->current.load(std::memory_order_seq_cst)->lst);
+            }
+
+        private:
+            reader(concurrent_list *l, slot *sl):lst(l), s(sl) { }
+
+        private:
+            concurrent_list *lst;
+            slot *s;
+        };
+
+
+        //Read section over one published version. Only one guard per reader may be alive.
+        template<typename T, typename Allocator>
+        class concurrent_list<T, Allocator>::pinned{
+            friend class reader;
+
+        public:
+            pinned(pinned &&rhs)noexcept:s(rhs.s), v(rhs.v){
+                rhs.s = nullptr;
+            }
+
+            pinned(const pinned &) = delete;
+            pinned &operator=(const pinned &) = delete;
+
+            ~pinned(){
+                if(s)
+                    s->epoch.store(0, std::memory_order_release);
+            }
+
+            const version_type &operator*()const{
+                return *v;
+            }
+
+            const version_type *operator->()const{
+                return v;
+            }
+
+            const value_type &operator[](size_t pos)const{
+                return (*v)[pos];
+            }
+
+        private:
+            pinned(slot *sl, const version_type *ver):s(sl), v(ver) { }
+
+        private:
+            slot *s;
+            const version_type *v;
+        };
+
+
+    }   //!version_0
+
+
+}   //!stl
+
+
+#endif  //!__CONCURRENT_LIST_HPP__
@@ -1,67 +1,562 @@
 #ifndef __EFFICIENT_LIST_HPP__
 #define __EFFICIENT_LIST_HPP__
 
-#include <stack>
+#include <functional>
 #include <initializer_list>
 #include <stdexcept>
+#include <system_error>
 #include <type_traits>
+#include <future>
 #include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+#include "node_pool.hpp"
 
 namespace stl{
 
     inline namespace version_0{
 
 
-        template<typename T>  class he_list_iterator;
-        template<typename T>  class he_list_const_iterator;
+        struct he_list_plain;
 
-        //Highly Efficient List
+        template<typename T, typename Augment = he_list_plain>  class he_list_iterator;
+        template<typename T, typename Augment = he_list_plain>  class he_list_const_iterator;
+
+        template<typename U, typename Augment> struct he_list_node;
+        template<typename T> class frozen_list;
+
+        //Default augment policy of he_list: nodes carry nothing beyond their links and value.
+        struct he_list_plain{ };
+
+        //Subtree aggregate of a he_list node. A policy providing
+        //  aggregate_type                          summary of a range, e.g. its sum or minimum
+        //  static aggregate_type unit()            summary of the empty range
+        //  static aggregate_type lift(const U &val)
+        //  static aggregate_type combine(a, b)     associative, a summarizes the left part
+        //enables he_list::query. Together with an action_type (see he_list_lazy) it must also
+        //provide static void apply(const action_type &f, aggregate_type &agg, size n) and
+        //combine must be commutative if reverse is used.
+        template<typename U, typename Augment, typename = void>
+        struct he_list_aggregate{
+            using aggregated = std::false_type;
+
+            struct node_data{ };
+
+            template<typename Node>
+            static void pull(Node *){ }
+
+            template<typename Node, typename Action>
+            static void on_apply(Node *, const Action &){ }
+
+            template<typename Node>
+            static void on_assign(Node *){ }
+        };
+
+        template<typename U, typename Augment>
+        struct he_list_aggregate<U, Augment, std::void_t<typename Augment::aggregate_type>>{
+            using aggregated = std::true_type;
+            using aggregate_type = typename Augment::aggregate_type;
+
+            struct node_data{
+                aggregate_type agg = Augment::unit();
+            };
+
+            template<typename Node>
+            static aggregate_type of(const Node *nd){
+                return nd?nd->agg:Augment::unit();
+            }
+
+            //recompute the aggregate of nd from its value and its children
+            template<typename Node>
+            static void pull(Node *nd){
+                nd->agg = Augment::combine(Augment::combine(of(nd->left), Augment::lift(nd->val)), of(nd->right));
+            }
+
+            template<typename Node, typename Action>
+            static void on_apply(Node *nd, const Action &f){
+                Augment::apply(f, nd->agg, nd->size);
+            }
+
+            //every element of the subtree of nd now equals nd->val
+            template<typename Node>
+            static void on_assign(Node *nd){
+                auto a = Augment::lift(nd->val);
+                auto r = Augment::unit();
+                for(auto n = nd->size; n; n >>= 1){
+                    if(n & 1)
+                        r = Augment::combine(r, a);
+                    a = Augment::combine(a, a);
+                }
+                nd->agg = r;
+            }
+
+            //aggregate of positions [l, r) of the subtree of cur, 0 <= l < r <= cur->size
+            template<typename Node, typename Push>
+            static aggregate_type query(Node *cur, unsigned long long l, unsigned long long r, Push push){
+                if(l == 0 && r == cur->size)
+                    return cur->agg;
+
+                push(cur);
+                auto lsz = cur->left?cur->left->size:0;
+                auto res = Augment::unit();
+                if(l < lsz)
+                    res = query(cur->left, l, r < lsz?r:lsz, push);
+                if(l <= lsz && lsz < r)
+                    res = Augment::combine(res, Augment::lift(cur->val));
+                if(r > lsz+1)
+                    res = Augment::combine(res, query(cur->right, l > lsz+1?l-lsz-1:0, r-lsz-1, push));
+                return res;
+            }
+        };
+
+        //Pending range operations of a he_list node. A policy providing
+        //  action_type                             a pending modification of elements
+        //  static action_type identity()           the action leaving elements unchanged
+        //  static action_type compose(f, g)        the action doing g first, then f
+        //  static void apply(const action_type &f, U &val)
+        //enables the lazy range operations reverse, apply and assign.
+        template<typename U, typename Augment, typename = void>
+        struct he_list_lazy{
+            using lazy = std::false_type;
+
+            struct node_data{ };
+            struct list_data{ };
+
+            template<typename Node>
+            static void push_down(Node *){ }
+
+            template<typename Node>
+            static void flush(list_data &, Node *){ }
+
+            static void merge(list_data &, const list_data &){ }
+        };
+
+        template<typename U, typename Augment>
+        struct he_list_lazy<U, Augment, std::void_t<typename Augment::action_type>>{
+            using lazy = std::true_type;
+            using action_type = typename Augment::action_type;
+            using aggregate = he_list_aggregate<U, Augment>;
+
+            //Tags of a node are pending for its children only: the value and the
+            //child links of the node itself are always up to date.
+            struct node_data{
+                std::optional<U> fill;
+                action_type act = Augment::identity();
+                bool has_act = false;
+                bool rev = false;
+            };
+
+            //set while any node of the list may hold a tag
+            struct list_data{
+                bool dirty = false;
+            };
+
+            template<typename Node>
+            static void reverse(Node *nd){
+                std::swap(nd->left, nd->right);
+                nd->rev = !nd->rev;
+            }
+
+            template<typename Node>
+            static void apply(Node *nd, const action_type &f){
+                Augment::apply(f, nd->val);
+                aggregate::on_apply(nd, f);
+                nd->act = nd->has_act ? Augment::compose(f, nd->act) : f;
+                nd->has_act = true;
+            }
+
+            template<typename Node>
+            static void assign(Node *nd, const U &val){
+                nd->val = val;
+                aggregate::on_assign(nd);
+                nd->fill = val;
+                nd->act = Augment::identity();
+                nd->has_act = false;
+            }
+
+            template<typename Node>
+            static void push_down(Node *nd){
+                if(!nd->fill && !nd->has_act && !nd->rev)
+                    return;
+
+                for(auto c : {nd->left, nd->right}){
+                    if(!c)
+                        continue;
+                    if(nd->fill)
+                        assign(c, *nd->fill);
+                    if(nd->has_act)
+                        apply(c, nd->act);
+                    if(nd->rev)
+                        reverse(c);
+                }
+                nd->fill.reset();
+                nd->act = Augment::identity();
+                nd->has_act = false;
+                nd->rev = false;
+            }
+
+            //push every tag down to the leaves, so that the links can be walked directly
+            template<typename Node>
+            static void flush(list_data &d, Node *root){
+                if(d.dirty){
+                    push_all(root);
+                    d.dirty = false;
+                }
+            }
+
+            static void merge(list_data &d, const list_data &rhs){
+                d.dirty = d.dirty || rhs.dirty;
+            }
+
+        private:
+            template<typename Node>
+            static void push_all(Node *cur){
+                if(!cur)
+                    return;
+
+                push_down(cur);
+                push_all(cur->left);
+                push_all(cur->right);
+            }
+        };
+
+        //Everything an augment policy adds to a he_list; policies providing neither an
+        //aggregate_type nor an action_type cost nothing.
+        template<typename U, typename Augment>
+        struct he_list_augment : he_list_lazy<U, Augment>, he_list_aggregate<U, Augment>{
+            struct node_data : he_list_lazy<U, Augment>::node_data, he_list_aggregate<U, Augment>::node_data { };
+        };
+
+        //Snapshot of the counters of an instrumented he_list, see he_list_counting.
+        //height and balance describe the shape at the time of the snapshot; balance is
+        //height over the height of a perfectly balanced tree of the same size.
+        struct he_list_stats{
+            unsigned long long rotations_ll = 0, rotations_lr = 0, rotations_rr = 0, rotations_rl = 0;
+            unsigned long long searches = 0, search_depth_total = 0, search_depth_max = 0;
+            unsigned long long allocations = 0, frees = 0;
+            unsigned long long size = 0, height = 0;
+            double balance = 1;
+        };
+
+        enum class he_list_rotation{ ll, lr, rr, rl };
+
+        //Default instrumentation policy of he_list: every hook is empty and the list
+        //stores nothing for it, so the hooks compile away.
+        struct he_list_no_stats{
+            struct list_data{ };
+
+            static void rotated(const list_data &, he_list_rotation){ }
+            static void searched(const list_data &, unsigned long long){ }
+            static void allocated(const list_data &, unsigned long long){ }
+            static void freed(const list_data &, unsigned long long){ }
+            static he_list_stats counts(const list_data &){ return he_list_stats(); }
+        };
+
+        //Opt-in instrumentation policy: counts the rebalancing cases of matain, the depth of
+        //positional searches and node allocations and frees of the list it is given to.
+        //Counters are plain integers, so an instrumented list must not be searched from
+        //several threads at once.
+        struct he_list_counting{
+            struct list_data{
+                mutable he_list_stats stats;
+            };
+
+            static void rotated(const list_data &d, he_list_rotation r){
+                switch(r){
+                    case he_list_rotation::ll: ++d.stats.rotations_ll; break;
+                    case he_list_rotation::lr: ++d.stats.rotations_lr; break;
+                    case he_list_rotation::rr: ++d.stats.rotations_rr; break;
+                    case he_list_rotation::rl: ++d.stats.rotations_rl; break;
+                }
+            }
+
+            static void searched(const list_data &d, unsigned long long depth){
+                ++d.stats.searches;
+                d.stats.search_depth_total += depth;
+                if(depth > d.stats.search_depth_max)
+                    d.stats.search_depth_max = depth;
+            }
+
+            static void allocated(const list_data &d, unsigned long long n){
+                d.stats.allocations += n;
+            }
+
+            static void freed(const list_data &d, unsigned long long n){
+                d.stats.frees += n;
+            }
+
+            static he_list_stats counts(const list_data &d){
+                return d.stats;
+            }
+        };
+
+        //Links shared by the nodes and the header of a he_list. The header is the end()
+        //position: its left child is the root and it is the parent of the root.
+        template<typename U, typename Augment>
+        struct he_list_node_base{
+            he_list_node_base *parent = nullptr;
+            he_list_node<U, Augment> *left = nullptr;
+            he_list_node<U, Augment> *right = nullptr;
+            unsigned long long size = 0;
+            static he_list_node_base *next(he_list_node_base *x){
+                if(x->right){
+                    x = x->right;
+                    while(x->left)
+                        x = x->left;
+                    return x;
+                }
+
+                auto p = x->parent;
+                while(p->right == x){
+                    x = p;
+                    p = p->parent;
+                }
+                return p;
+            }
+
+            static he_list_node_base *prev(he_list_node_base *x){
+                if(x->left){
+                    x = x->left;
+                    while(x->right)
+                        x = x->right;
+                    return x;
+                }
+
+                auto p = x->parent;
+                while(p->left == x){
+                    x = p;
+                    p = p->parent;
+                }
+                return p;
+            }
+
+            static unsigned long long size_of(const he_list_node_base *x){
+                return x?x->size:0;
+            }
+
+            //in-order position of x, the header is at position size()
+            static unsigned long long rank(const he_list_node_base *x){
+                auto r = size_of(x->left);
+                for(auto p = x->parent; p; x = p, p = p->parent){
+                    if(p->right == x)
+                        r += size_of(p->left) + 1;
+                }
+                return r;
+            }
+
+            //Move d positions away from x: climb until the target falls into the current
+            //subtree, then descend. Costs O(log n), and less for nearby targets.
+            static he_list_node_base *jump(he_list_node_base *x, long long d){
+                while(d < -static_cast<long long>(size_of(x->left)) || d > static_cast<long long>(size_of(x->right))){
+                    auto p = x->parent;
+                    if(p->left == x)
+                        d -= size_of(x->right) + 1;
+                    else
+                        d += size_of(x->left) + 1;
+                    x = p;
+                }
+
+                while(d){
+                    if(d < 0){
+                        x = x->left;
+                        d += size_of(x->right) + 1;
+                    }
+                    else{
+                        x = x->right;
+                        d -= size_of(x->left) + 1;
+                    }
+                }
+                return x;
+            }
+        };
+
+        template<typename U, typename Augment>
+        struct he_list_node : he_list_node_base<U, Augment>, he_list_augment<U, Augment>::node_data{
+            U val;
+
+            template<typename... Args>
+            explicit he_list_node(Args&&... args):val(std::forward<Args>(args)...) { this->size = 1; }
+        };
+
+        //Immutable contiguous image of a he_list for read-mostly phases. The elements are
+        //stored in order, so operator[] is plain indexing and iteration a linear scan.
+        //Made by he_list::freeze() and turned back into a tree by he_list::thaw().
         template<typename T>
+        class frozen_list{
+            template<typename V, typename A, typename G, typename S> friend class he_list;
+
+        public:
+            using value_type = T;
+            using size_t = unsigned long long;
+            using const_iterator = const T*;
+            using iterator = const_iterator;
+
+        public:
+            frozen_list()noexcept:elems(nullptr), n(0), cap(0){ }
+
+            frozen_list(frozen_list &&rhs)noexcept:
+                frozen_list(){
+                swap(rhs);
+            }
+
+            frozen_list &operator=(frozen_list &&rhs)noexcept{
+                frozen_list tmp(std::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+
+            frozen_list(const frozen_list &) = delete;
+            frozen_list &operator=(const frozen_list &) = delete;
+
+            ~frozen_list(){
+                reset();
+            }
+
+            void swap(frozen_list &rhs)noexcept{
+                std::swap(elems, rhs.elems);
+                std::swap(n, rhs.n);
+                std::swap(cap, rhs.cap);
+            }
+
+        public:
+            size_t size()const noexcept{
+                return n;
+            }
+
+            bool empty()const noexcept{
+                return !n;
+            }
+
+            const value_type &operator[](size_t pos)const{
+                return elems[pos];
+            }
+
+            const value_type &at(size_t pos)const{
+                if(pos >= n)
+                    throw std::runtime_error("Out of range.");
+                return elems[pos];
+            }
+
+            const value_type &front()const{
+                return at(0);
+            }
+
+            const value_type &back()const{
+                return at(n-1);
+            }
+
+            const value_type *data()const noexcept{
+                return elems;
+            }
+
+            const_iterator begin()const noexcept{
+                return elems;
+            }
+
+            const_iterator end()const noexcept{
+                return elems + n;
+            }
+
+        private:
+            //raw storage for cnt elements, constructed by the owner one by one
+            explicit frozen_list(size_t cnt):
+                elems(cnt ? std::allocator<T>().allocate(cnt) : nullptr), n(0), cap(cnt){
+            }
+
+            void reset()noexcept{
+                for(size_t i=0; i<n; ++i)
+                    elems[i].~T();
+                if(elems)
+                    std::allocator<T>().deallocate(elems, cap);
+                elems = nullptr;
+                n = cap = 0;
+            }
+
+        private:
+            T *elems;
+            size_t n, cap;
+        };
+
+        //Highly Efficient List
+        template<typename T, typename Allocator = node_pool<T>, typename Augment = he_list_plain, typename Stats = he_list_no_stats>
         class he_list{
-            template<typename V> friend class he_list;
-            friend class he_list_iterator<T>;
-            friend class he_list_const_iterator<T>;
+            template<typename V, typename A, typename G, typename S> friend class he_list;
+            friend class he_list_iterator<T, Augment>;
+            friend class he_list_const_iterator<T, Augment>;
 
         public:
             using value_type = T;
             using size_t = unsigned long long;
-            using iterator = he_list_iterator<T>;
-            using const_iterator = he_list_const_iterator<T>;
+            using iterator = he_list_iterator<T, Augment>;
+            using const_iterator = he_list_const_iterator<T, Augment>;
+
+            class cursor;
 
         private:
-            template<typename U>
-            struct Node{
-                U val;
-                Node *left;
-                Node *right;
-                size_t size;
-
-                explicit Node(const U &k):val(k), left(nullptr), right(nullptr), size(1) { }
-                explicit Node(U &&k):val(std::move(k)), left(nullptr), right(nullptr), size(1) { }
-            };
+            using node_type = he_list_node<T, Augment>;
+            using base_type = he_list_node_base<T, Augment>;
+            using augment = he_list_augment<T, Augment>;
+
+            struct header_type : base_type, augment::list_data, Stats::list_data { };
+            using alloc_traits = typename std::allocator_traits<Allocator>::template rebind_traits<node_type>;
+            using node_allocator = typename alloc_traits::allocator_type;
+
+        public:
+            //Allocator rebound to the nodes, the allocator that actually holds them.
+            using allocator_type = node_allocator;
+
+        private:
+
+            //allocators providing release() (e.g. node_pool) can drop all nodes at once
+            template<typename A, typename = void>
+            struct releasable : std::false_type { };
 
-            using node_type = Node<T>;
+            template<typename A>
+            struct releasable<A, decltype(std::declval<A&>().release())> : std::true_type { };
+
+            //How worker threads get nodes: pools hand each task a private arena that is
+            //adopted afterwards, stateless allocators are shared, anything else stays serial.
+            struct pooled_alloc { };
+            struct shared_alloc { };
+            struct serial_alloc { };
+
+            using parallel_alloc = std::conditional_t<releasable<node_allocator>::value, pooled_alloc,
+                                        std::conditional_t<alloc_traits::is_always_equal::value, shared_alloc, serial_alloc>>;
+
+            //bound on the height of a size balanced tree of 2^64 nodes
+            static constexpr unsigned max_height = 96;
+
+            //subtrees below this size are not worth a thread
+            static constexpr unsigned long long parallel_grain = 1 << 14;
 
         public:
-            he_list():root(nullptr){ }
+            he_list(){ }
+
+            explicit he_list(const Allocator &a):alloc(a){ }
+
+            //with a node_pool this shares its arena with the list a came from; when
+            //Allocator already is the node allocator the constructor above does it
+            template<typename A, typename = std::enable_if_t<std::is_same<A, allocator_type>::value &&
+                                                             !std::is_same<A, Allocator>::value>>
+            explicit he_list(const A &a):alloc(a){ }
 
             he_list(size_t n, const value_type &value = value_type{}):
                 he_list(){
-                for(size_t i=0; i<n; ++i)
-                    push_back(value);
+                auto gen = [&value]()->const value_type&{ return value; };
+                set_root(build(n, gen));
             }
 
             he_list(size_t n, value_type &&value):
-                he_list(){
-                for(size_t i=0; i<n; ++i)
-                    push_back(std::move(value));
+                he_list(n, static_cast<const value_type&>(value)){
             }
 
             template<typename V>
             he_list(std::initializer_list<V> lst):
                 he_list() {
-                for(auto &val : lst)
-                    push_back(std::move(val));
+                assign(lst.begin(), lst.end());
             }
 
             template<typename Iterator, typename = std::enable_if_t<
@@ -73,20 +568,34 @@ namespace stl{
                     >
             he_list(Iterator beg, Iterator end):
                 he_list(){
-                for(auto it = beg; it != end; ++it)
-                    push_back(*it);
+                assign(beg, end);
             }
 
-            he_list(const he_list &rhs): root(copy<T>(rhs.root)){ }
+            he_list(const he_list &rhs):
+                alloc(alloc_traits::select_on_container_copy_construction(rhs.alloc)){
+                set_root(copy(rhs.root()));
+            }
 
-            template<typename V>
-            he_list(const he_list<V> &rhs): root(copy<V>(rhs.root)){ }
+            template<typename V, typename A, typename G, typename S>
+            he_list(const he_list<V, A, G, S> &rhs):
+                he_list(){
+                set_root(copy(rhs.root()));
+            }
 
             he_list(he_list &&rhs)noexcept:
-                root(rhs.root){
-                rhs.root = nullptr;
+                alloc(std::move(rhs.alloc)){
+                take_root(rhs);
             }
 
+        private:
+            //adopt a detached tree whose nodes were allocated through a
+            he_list(node_type *r, const node_allocator &a, const typename augment::list_data &d):alloc(a){
+                set_root(r);
+                augment::merge(header, d);
+            }
+
+        public:
+
             ~he_list(){
                 free_mem();
             }
@@ -95,190 +604,1059 @@ namespace stl{
                 return operator=<T>(rhs);
             }
 
-            template<typename V>
-            he_list &operator=(const he_list<V> &rhs){
-                auto tmp = copy<V>(rhs.root);
-                free_mem();
-                root = tmp;
-
-                return *this;
+            template<typename V, typename A, typename G, typename S>
+            he_list &operator=(const he_list<V, A, G, S> &rhs){
+                he_list tmp(rhs);
+                return operator=(std::move(tmp));
             }
 
             he_list &operator=(he_list &&rhs)noexcept{
                 if(this != &rhs){
-                    root = rhs.root;
-                    rhs.root = nullptr;
+                    free_mem();
+                    move_from(rhs, typename alloc_traits::propagate_on_container_move_assignment());
                 }
 
                 return *this;
             }
 
+            //a handle on the allocator of the nodes, it compares equal to the list's own
+            allocator_type get_allocator()const{
+                return alloc;
+            }
+
         public:
             size_t size()const{
-                return root?root->size:0;
+                return root()?root()->size:0;
             }
 
             bool empty()const{
-                return !root;
+                return !root();
+            }
+
+            //Counters of the Stats policy (all zero with he_list_no_stats) together with the
+            //current shape of the tree, which is measured in O(n). The counters belong to
+            //the tree: a move hands them to the target and resets the source.
+            he_list_stats stats()const{
+                auto st = Stats::counts(header);
+                st.size = size();
+                st.height = height_of(root());
+                size_t perfect = 0;
+                for(auto n = st.size; n; n >>= 1)
+                    ++perfect;
+                st.balance = perfect ? double(st.height) / perfect : 1;
+                return st;
             }
 
         public:
-            void insert(size_t pos, const value_type &val){
+            //Replace the contents with [beg, end). Sized (forward) ranges are built
+            //directly as a perfectly balanced tree in O(n) without any rotation.
+            template<typename Iterator>
+            void assign(Iterator beg, Iterator end){
+                free_mem();
+                append_range(beg, end);
+            }
+
+            //Append [beg, end) in O(k + log n): the new elements are built as one
+            //balanced subtree and joined onto the right spine.
+            template<typename Iterator>
+            void append_range(Iterator beg, Iterator end){
+                append_range(beg, end, typename std::iterator_traits<Iterator>::iterator_category());
+            }
+
+            //Cut the list at pos and return [pos, size()) as a new list in O(log n). With a
+            //node_pool both lists keep sharing one arena, so they must stay on one thread
+            //until unshare() gives one of them an arena of its own.
+            he_list split(size_t pos){
+                check(pos, size()+1);
+                node_type *l, *r;
+                split_node(root(), pos, l, r);
+                set_root(l);
+                return he_list(r, alloc, header);
+            }
+
+            //Move the elements into a node_pool arena of their own in O(n) if other lists
+            //still share the arena, e.g. after split. Afterwards the list may go to another
+            //thread, and a small part no longer keeps the memory of a large arena alive.
+            void unshare(){
+                unshare(releasable<node_allocator>());
+            }
+
+            //Append all elements of rhs in O(log n), leaving rhs empty. Of two node_pool
+            //arenas one takes over the other unless both are shared with further lists,
+            //in which case the elements of rhs are moved in O(rhs.size()).
+            void concat(he_list &&rhs){
+                if(this == &rhs || rhs.empty())
+                    return;
+
+                set_root(join(root(), take_nodes(rhs)));
+            }
+
+            //Move the elements into a frozen_list for a phase without writes and leave the
+            //list empty. Nothrow movable elements are moved on up to threads threads.
+            frozen_list<value_type> freeze(unsigned threads = 0){
+                flush();
+                frozen_list<value_type> f(size());
+                freeze_into(f, threads, std::is_nothrow_move_constructible<value_type>());
+                free_mem();
+                return f;
+            }
+
+            //Replace the contents with the elements of f in O(n), leaving f empty.
+            void thaw(frozen_list<value_type> &&f){
+                assign(std::make_move_iterator(f.elems), std::make_move_iterator(f.elems + f.n));
+                f.reset();
+            }
+
+            //Insert all elements of rhs before pos in O(log n), leaving rhs empty.
+            void splice(size_t pos, he_list &&rhs){
+                check(pos, size()+1);
+                if(this == &rhs || rhs.empty())
+                    return;
+
+                node_type *l, *r;
+                split_node(root(), pos, l, r);
+                set_root(join(join(l, take_nodes(rhs)), r));
+            }
+
+            //Lazy range operations on [l, r) in O(log n), available with an augment policy
+            //providing an action_type (see he_list_lazy). The range is cut out, tagged at
+            //its root and joined back; tags are pushed down only when a node is visited.
+            //They invalidate iterators and cursors.
+            void reverse(size_t l, size_t r){
+                range_op(l, r, [](node_type *nd){ augment::reverse(nd); });
+            }
+
+            template<typename Action>
+            void apply(size_t l, size_t r, const Action &f){
+                range_op(l, r, [&f](node_type *nd){ augment::apply(nd, f); });
+            }
+
+            void assign(size_t l, size_t r, const value_type &val){
+                range_op(l, r, [&val](node_type *nd){ augment::assign(nd, val); });
+            }
+
+            //Aggregate of [l, r) in O(log n), available with an augment policy providing an
+            //aggregate_type (see he_list_aggregate). Elements of such a list must only be
+            //changed through set and the range operations.
+            auto query(size_t l, size_t r)const{
+                static_assert(augment::aggregated::value, "he_list: query needs an augment policy with an aggregate_type");
+                check(l, r+1);
+                check(r, size()+1);
+                if(l == r)
+                    return Augment::unit();
+                return augment::query(root(), l, r, [](node_type *nd){ augment::push_down(nd); });
+            }
+
+            //Parallel algorithms. The tree is cut into disjoint subtrees by position, which
+            //are processed on up to threads threads (0: one per hardware thread); elements
+            //are visited in no particular order, but each exactly once.
+            template<typename F>
+            void for_each(F fn, unsigned threads = 0){
+                flush();
+                auto visit = [&fn](node_type *nd, size_t){ fn(nd->val); };
+                auto post = [](node_type *nd){ augment::pull(nd); };
+                par_walk(root(), 0, fork_depth(threads), visit, post);
+            }
+
+            template<typename F>
+            void for_each(F fn, unsigned threads = 0)const{
+                flush();
+                auto visit = [&fn](const node_type *nd, size_t){ fn(nd->val); };
+                auto post = [](node_type *){ };
+                par_walk(root(), 0, fork_depth(threads), visit, post);
+            }
+
+            //replace every element by fn(element)
+            template<typename F>
+            void transform(F fn, unsigned threads = 0){
+                for_each([&fn](value_type &val){ val = fn(val); }, threads);
+            }
+
+            //init combined with all elements in order by the associative op; as for std::reduce,
+            //op takes any mix of V and elements and V is constructible from an element
+            template<typename V, typename Op>
+            V reduce(V init, Op op, unsigned threads = 0)const{
+                flush();
+                if(!root())
+                    return init;
+                return op(std::move(init), par_reduce<V>(root(), fork_depth(threads), op));
+            }
+
+            //copy the elements to [out, out + size())
+            template<typename RandomIt>
+            RandomIt copy_to(RandomIt out, unsigned threads = 0)const{
+                flush();
+                auto visit = [&out](const node_type *nd, size_t i){ out[i] = nd->val; };
+                auto post = [](node_type *){ };
+                par_walk(root(), 0, fork_depth(threads), visit, post);
+                return out + size();
+            }
+
+            //Searches in order. They walk the tree with a stack instead of the parent links
+            //and prefetch each right subtree while its left one is visited, which pays off
+            //once the nodes are scattered in memory. index_of returns size() if val does not occur.
+            size_t index_of(const value_type &val)const{
+                size_t pos = 0;
+                scan([&val, &pos](const node_type *nd){
+                    if(nd->val == val)
+                        return false;
+                    ++pos;
+                    return true;
+                });
+                return pos;
+            }
+
+            size_t count(const value_type &val)const{
+                size_t cnt = 0;
+                scan([&val, &cnt](const node_type *nd){
+                    cnt += nd->val == val;
+                    return true;
+                });
+                return cnt;
+            }
+
+            iterator find(const value_type &val){
+                return iterator(node_at(index_of(val)));
+            }
+
+            const_iterator find(const value_type &val)const{
+                return const_iterator(const_cast<he_list*>(this)->node_at(index_of(val)));
+            }
+
+            //first smallest (largest) element as by std::min_element (std::max_element)
+            iterator min_element(){
+                return iterator(node_at(extremum(std::less<>())));
+            }
+
+            const_iterator min_element()const{
+                return const_iterator(const_cast<he_list*>(this)->node_at(extremum(std::less<>())));
+            }
+
+            iterator max_element(){
+                return iterator(node_at(extremum(std::greater<>())));
+            }
+
+            const_iterator max_element()const{
+                return const_iterator(const_cast<he_list*>(this)->node_at(extremum(std::greater<>())));
+            }
+
+            //construct an element in place before pos
+            template<typename... Args>
+            value_type &emplace(size_t pos, Args&&... args){
                 check(pos, size()+1);
-                root = add_node(root, pos, val);
+                auto nd = new_node(std::forward<Args>(args)...);
+                insert_before(node_at(pos), nd);
+                return nd->val;
+            }
+
+            template<typename... Args>
+            value_type &emplace_back(Args&&... args){
+                auto nd = new_node(std::forward<Args>(args)...);
+                insert_before(&header, nd);
+                return nd->val;
+            }
+
+            template<typename... Args>
+            value_type &emplace_front(Args&&... args){
+                auto nd = new_node(std::forward<Args>(args)...);
+                insert_before(leftmost(), nd);
+                return nd->val;
+            }
+
+            void insert(size_t pos, const value_type &val){
+                emplace(pos, val);
             }
 
             void insert(size_t pos, value_type &&val){
+                emplace(pos, std::move(val));
+            }
+
+            //Insert [beg, end) before pos. Sized (forward) ranges cost O(k + log n): the new
+            //elements are built as one balanced subtree and joined in at pos.
+            template<typename Iterator, typename = std::enable_if_t<
+                                        std::is_convertible<
+                                                typename std::iterator_traits<Iterator>::iterator_category,
+                                                std::input_iterator_tag
+                                                    >::value
+                                                                    >
+                    >
+            void insert(size_t pos, Iterator beg, Iterator end){
                 check(pos, size()+1);
-                root = add_node(root, pos, std::move(val));
+                insert_range(pos, beg, end, typename std::iterator_traits<Iterator>::iterator_category());
             }
 
             void erase(size_t pos){
                 check(pos, size());
-                root = erase_node(root, pos);
+                erase_at(search_node(root(), pos));
+            }
+
+            //Erase positions [first, last) in O(log n + k), k being the cost of freeing the
+            //nodes: the range is cut out as one subtree and the rest is joined again.
+            void erase(size_t first, size_t last){
+                check(first, last+1);
+                check(last, size()+1);
+                if(first == last)
+                    return;
+                if(last - first == size()){
+                    free_mem();
+                    return;
+                }
+
+                node_type *a, *b, *c;
+                split_node(root(), last, b, c);
+                split_node(b, first, a, b);
+                set_root(join(a, c));
+                Stats::freed(header, last - first);
+                auto del = [this](node_type *nd){ destroy_node(nd); };
+                par_drop(b, alloc_traits::is_always_equal::value ? fork_depth(0) : 0, del);
+            }
+
+            //Remove every element. With keep_capacity an unshared node pool keeps all of its
+            //memory for the next fill instead of returning it to the system.
+            void clear(bool keep_capacity = false){
+                free_mem(keep_capacity);
+            }
+
+            //replace the element at pos, keeping aggregates up to date
+            template<typename V>
+            void set(size_t pos, V &&val){
+                check(pos, size());
+                auto nd = search_node(root(), pos);
+                nd->val = std::forward<V>(val);
+                for(base_type *p = nd; p != &header; p = p->parent)
+                    augment::pull(static_cast<node_type*>(p));
+            }
+
+            void push_back(const value_type &val){
+                emplace_back(val);
+            }
+
+            void push_back(value_type &&val){
+                emplace_back(std::move(val));
+            }
+
+            void pop_back(){
+                check(0,size());
+                erase(size()-1);
+            }
+
+            void push_front(const value_type &val){
+                emplace_front(val);
+            }
+
+            void push_front(value_type &&val){
+                emplace_front(std::move(val));
+            }
+
+            void pop_front(){
+                erase(0);
+            }
+
+        public:
+            value_type &operator[](size_t pos){
+                check(pos, size());
+                auto nd = search_node(root(), pos);
+                return nd->val;
+            }
+
+            const value_type &operator[](size_t pos)const{
+                check(pos, size());
+                auto nd = search_node(root(), pos);
+                return nd->val;
+            }
+
+            value_type &back(){
+                return const_cast<value_type&>(
+                                    const_cast<const he_list *const>(this)->back());
+            }
+
+            const value_type &back()const{
+                check(0,size());
+                return static_cast<const node_type*>(rightmost())->val;
+            }
+
+            value_type &front(){
+                return const_cast<value_type&>(
+                                    const_cast<const he_list *const>(this)->front());
+            }
+
+            const value_type &front()const{
+                check(0,size());
+                return static_cast<const node_type*>(leftmost())->val;
+            }
+
+        public:
+            iterator begin(){
+                flush();
+                return iterator(leftmost());
+            }
+
+            iterator end(){
+                flush();
+                return iterator(&header);
+            }
+
+            const_iterator begin()const{
+                flush();
+                return const_iterator(leftmost());
+            }
+
+            const_iterator end()const{
+                flush();
+                return const_iterator(const_cast<header_type*>(&header));
+            }
+
+            const_iterator cbegin()const{
+                return begin();
+            }
+
+            const_iterator cend()const{
+                return end();
+            }
+
+            //cursor on position pos, see he_list::cursor
+            cursor cursor_at(size_t pos = 0){
+                check(pos, size()+1);
+                flush();
+                return cursor(this, base_type::jump(&header, static_cast<long long>(pos) - static_cast<long long>(size())), pos);
+            }
+
+        private:
+            node_type *root()const{
+                return header.left;
+            }
+
+            void set_root(node_type *r){
+                header.left = r;
+                if(r)
+                    r->parent = &header;
+            }
+
+            base_type *leftmost()const{
+                base_type *x = const_cast<header_type*>(&header);
+                for(auto c = root(); c; c = c->left){
+                    augment::push_down(c);
+                    x = c;
+                }
+                return x;
+            }
+
+            base_type *rightmost()const{
+                base_type *x = const_cast<header_type*>(&header);
+                for(auto c = root(); c; c = c->right){
+                    augment::push_down(c);
+                    x = c;
+                }
+                return x;
+            }
+
+            //settle all pending tags before the links are walked without a descent
+            void flush()const{
+                augment::flush(const_cast<header_type&>(header), root());
+            }
+
+            template<typename F>
+            void range_op(size_t l, size_t r, F fn){
+                static_assert(augment::lazy::value, "he_list: range operations need an augment policy with an action_type");
+                check(l, r+1);
+                check(r, size()+1);
+                if(l == r)
+                    return;
+
+                node_type *a, *b, *c;
+                split_node(root(), r, b, c);
+                split_node(b, l, a, b);
+                fn(b);
+                header.dirty = true;
+                set_root(join(join(a, b), c));
+            }
+
+            static void link_left(node_type *p, node_type *c){
+                p->left = c;
+                if(c)
+                    c->parent = p;
+            }
+
+            static void link_right(node_type *p, node_type *c){
+                p->right = c;
+                if(c)
+                    c->parent = p;
+            }
+
+            static void update(node_type *cur){
+                cur->size = (cur->left?cur->left->size:0) + (cur->right?cur->right->size:0) + 1;
+                augment::pull(cur);
+            }
+
+            void check(size_t pos, size_t range)const{
+                if(pos >= range)
+                    throw std::runtime_error("Out of range.");
+            }
+
+            template<typename... Args>
+            node_type *new_node(Args&&... args){
+                auto nd = make_node(alloc, std::forward<Args>(args)...);
+                Stats::allocated(header, 1);
+                return nd;
+            }
+
+            template<typename... Args>
+            static node_type *make_node(node_allocator &a, Args&&... args){
+                auto nd = alloc_traits::allocate(a, 1);
+                try{
+                    alloc_traits::construct(a, nd, std::forward<Args>(args)...);
+                }
+                catch(...){
+                    alloc_traits::deallocate(a, nd, 1);
+                    throw;
+                }
+                augment::pull(nd);
+                return nd;
+            }
+
+            void delete_node(node_type *nd){
+                Stats::freed(header, 1);
+                destroy_node(nd);
+            }
+
+            //not counted, so that it may run on many threads; callers count in bulk
+            void destroy_node(node_type *nd){
+                alloc_traits::destroy(alloc, nd);
+                alloc_traits::deallocate(alloc, nd, 1);
+            }
+
+            //copies settle the tags of the source on the way, the copy holds none
+            template<typename V, typename G>
+            node_type *copy(const he_list_node<V, G> *cur){
+                Stats::allocated(header, cur ? cur->size : 0);
+                return copy(cur, alloc, fork_depth(0), parallel_alloc());
+            }
+
+            //the left subtree of large copies is copied on its own thread
+
+            template<typename V, typename G, typename Mode>
+            static node_type *copy(const he_list_node<V, G> *cur, node_allocator &a, unsigned depth, Mode mode){
+                if(!cur)
+                    return nullptr;
+
+                he_list_augment<V, G>::push_down(const_cast<he_list_node<V, G>*>(cur));
+                auto nd = make_node(a, cur->val);
+                nd->size = cur->size;
+                if(!depth || cur->size < parallel_grain){
+                    link_left(nd, copy(cur->left, a, 0, mode));
+                    link_right(nd, copy(cur->right, a, 0, mode));
+                }
+                else{
+                    copy_children(nd, cur, a, depth-1, mode);
+                }
+                augment::pull(nd);
+                return nd;
+            }
+
+            template<typename V, typename G, typename Mode>
+            static void copy_children(node_type *nd, const he_list_node<V, G> *cur, node_allocator &a, unsigned depth, Mode mode){
+                auto la = fork_alloc(a, mode);
+                auto left = fork([&]{ return copy(cur->left, la, depth, mode); });
+                link_right(nd, copy(cur->right, a, depth, mode));
+                if(left.valid())
+                    link_left(nd, left.get());
+                else
+                    link_left(nd, copy(cur->left, a, depth, mode));
+                join_alloc(a, la, mode);
+            }
+
+            template<typename V, typename G>
+            static void copy_children(node_type *nd, const he_list_node<V, G> *cur, node_allocator &a, unsigned, serial_alloc mode){
+                link_left(nd, copy(cur->left, a, 0, mode));
+                link_right(nd, copy(cur->right, a, 0, mode));
+            }
+
+            static node_allocator fork_alloc(node_allocator &, pooled_alloc){
+                return node_allocator();
+            }
+
+            static node_allocator fork_alloc(node_allocator &a, shared_alloc){
+                return a;
+            }
+
+            //the arena of the task joins the arena of the list in O(1)
+            static void join_alloc(node_allocator &a, node_allocator &la, pooled_alloc){
+                a.adopt(la);
+            }
+
+            static void join_alloc(node_allocator &, node_allocator &, shared_alloc){ }
+
+            //Starts fn on a thread of its own. If no thread can be started the future is
+            //left empty and the caller runs the work itself.
+            template<typename F>
+            static auto fork(F fn){
+                std::future<decltype(fn())> f;
+                try{
+                    f = std::async(std::launch::async, std::move(fn));
+                }
+                catch(const std::system_error &){ }
+                catch(const std::bad_alloc &){ }
+                return f;
+            }
+
+            static unsigned fork_depth(unsigned threads){
+                if(!threads)
+                    threads = std::thread::hardware_concurrency();
+                unsigned d = 0;
+                while((1u << d) < threads)
+                    ++d;
+                return d;
+            }
+
+            //in-order visit of the subtree of cur starting at position base, the left
+            //subtrees of the top depth levels run on their own threads; post runs on
+            //every node after its children
+            template<typename F, typename Post>
+            static void par_walk(node_type *cur, size_t base, unsigned depth, F &fn, Post &post){
+                if(!cur)
+                    return;
+
+                auto lsz = base_type::size_of(cur->left);
+                std::future<void> left;
+                if(depth && cur->size >= parallel_grain)
+                    left = fork([&]{ par_walk(cur->left, base, depth-1, fn, post); });
+                if(left.valid()){
+                    fn(cur, base + lsz);
+                    par_walk(cur->right, base + lsz + 1, depth-1, fn, post);
+                    left.get();
+                }
+                else{
+                    par_walk(cur->left, base, 0, fn, post);
+                    fn(cur, base + lsz);
+                    par_walk(cur->right, base + lsz + 1, 0, fn, post);
+                }
+                post(cur);
+            }
+
+            template<typename V, typename Op>
+            static V par_reduce(node_type *cur, unsigned depth, Op &op){
+                std::future<V> left;
+                if(cur->left && depth && cur->size >= parallel_grain)
+                    left = fork([&]{ return par_reduce<V>(cur->left, depth-1, op); });
+
+                std::optional<V> right;
+                if(cur->right)
+                    right.emplace(par_reduce<V>(cur->right, depth?depth-1:0, op));
+
+                std::optional<V> acc;
+                if(left.valid())
+                    acc.emplace(op(left.get(), cur->val));
+                else if(cur->left)
+                    acc.emplace(op(par_reduce<V>(cur->left, 0, op), cur->val));
+                else
+                    acc.emplace(cur->val);
+
+                if(right)
+                    return op(std::move(*acc), std::move(*right));
+                return std::move(*acc);
+            }
+
+            //the counters of the Stats policy move along with the tree
+            void take_root(he_list &rhs){
+                set_root(rhs.root());
+                augment::merge(header, rhs.header);
+                static_cast<typename Stats::list_data&>(header) = static_cast<typename Stats::list_data&>(rhs.header);
+                rhs.set_root(nullptr);
+                rhs.header = header_type();
+            }
+
+            void move_from(he_list &rhs, std::true_type){
+                alloc = std::move(rhs.alloc);
+                take_root(rhs);
+            }
+
+            void move_from(he_list &rhs, std::false_type){
+                if(alloc == rhs.alloc){
+                    take_root(rhs);
+                }
+                else{
+                    set_root(copy(rhs.root()));
+                }
+            }
+
+            template<typename Iterator>
+            void append_range(Iterator beg, Iterator end, std::input_iterator_tag){
+                for(; beg != end; ++beg)
+                    push_back(*beg);
+            }
+
+            template<typename Iterator>
+            void append_range(Iterator beg, Iterator end, std::forward_iterator_tag){
+                size_t n = std::distance(beg, end);
+                if(!n)
+                    return;
+
+                auto gen = [&beg]()->typename std::iterator_traits<Iterator>::reference{ return *beg++; };
+                if(!root()){
+                    set_root(build(n, gen));
+                    return;
+                }
+
+                auto mid = new_node(gen());
+                node_type *rest;
+                try{
+                    rest = build(n-1, gen);
+                }
+                catch(...){
+                    delete_node(mid);
+                    throw;
+                }
+                set_root(join(root(), mid, rest));
+            }
+
+            template<typename Iterator>
+            void insert_range(size_t pos, Iterator beg, Iterator end, std::input_iterator_tag){
+                he_list tmp(get_allocator());
+                tmp.append_range(beg, end);
+                splice(pos, std::move(tmp));
+            }
+
+            template<typename Iterator>
+            void insert_range(size_t pos, Iterator beg, Iterator end, std::forward_iterator_tag){
+                size_t n = std::distance(beg, end);
+                if(!n)
+                    return;
+
+                auto gen = [&beg]()->typename std::iterator_traits<Iterator>::reference{ return *beg++; };
+                auto mid = build(n, gen);
+                node_type *l, *r;
+                split_node(root(), pos, l, r);
+                set_root(join(join(l, mid), r));
             }
 
-            void push_back(const value_type &val){
-                root = add_node(root, size(), val);
+            //in-order walk calling fn(node) until it returns false
+            template<typename F>
+            void scan(F fn)const{
+                flush();
+                const node_type *stack[max_height];
+                unsigned top = 0;
+                for(const node_type *cur = root(); ; cur = cur->right){
+                    for(; cur; cur = cur->left){
+                        __builtin_prefetch(cur->right);
+                        stack[top++] = cur;
+                    }
+                    if(!top)
+                        return;
+                    cur = stack[--top];
+                    if(!fn(cur))
+                        return;
+                }
             }
 
-            void push_back(value_type &&val){
-                root = add_node(root, size(), std::move(val));
+            //position of the first element no other element is better than
+            template<typename Better>
+            size_t extremum(Better better)const{
+                const node_type *best = nullptr;
+                size_t pos = 0, i = 0;
+                scan([&](const node_type *nd){
+                    if(!best || better(nd->val, best->val)){
+                        best = nd;
+                        pos = i;
+                    }
+                    ++i;
+                    return true;
+                });
+                return best ? pos : size();
             }
 
-            void pop_back(){
-                check(0,size());
-                erase(size()-1);
+            //The moves cannot throw and a task that cannot be started runs on the calling
+            //thread, so the walk always builds all of f; noexcept keeps a half-built f from
+            //ever escaping with a wrong f.n.
+            void freeze_into(frozen_list<value_type> &f, unsigned threads, std::true_type)noexcept{
+                auto out = f.elems;
+                auto visit = [out](node_type *nd, size_t i){ ::new(static_cast<void*>(out + i)) value_type(std::move(nd->val)); };
+                auto post = [](node_type *){ };
+                par_walk(root(), 0, fork_depth(threads), visit, post);
+                f.n = size();
             }
 
-            void push_front(const value_type &val){
-                root = add_node(root, 0, val);
+            //in order, so that f always owns exactly its first f.n elements
+            void freeze_into(frozen_list<value_type> &f, unsigned, std::false_type){
+                for(auto &val : *this){
+                    ::new(static_cast<void*>(f.elems + f.n)) value_type(std::move(val));
+                    ++f.n;
+                }
             }
 
-            void push_front(value_type &&val){
-                root = add_node(root, 0, std::move(val));
+            //In-order construction of a perfectly balanced tree from n generated values.
+            //If a value throws, the nodes built so far are freed before rethrowing.
+            template<typename Generator>
+            node_type *build(size_t n, Generator &gen){
+                if(!n)
+                    return nullptr;
+
+                auto lsz = (n-1) / 2;
+                auto l = build(lsz, gen);
+                node_type *nd;
+                try{
+                    nd = new_node(gen());
+                }
+                catch(...){
+                    drop_subtree(l);
+                    throw;
+                }
+                link_left(nd, l);
+                try{
+                    link_right(nd, build(n-1-lsz, gen));
+                }
+                catch(...){
+                    drop_subtree(nd);
+                    throw;
+                }
+                nd->size = n;
+                augment::pull(nd);
+                return nd;
             }
 
-            void pop_front(){
-                erase(0);
+            //free a detached subtree
+            void drop_subtree(node_type *cur){
+                auto del = [this](node_type *nd){ delete_node(nd); };
+                par_drop(cur, 0, del);
             }
 
-        public:
-            value_type &operator[](size_t pos){
-                check(pos, size());
-                auto nd = search_node(root, pos);
-                return nd->val;
+            //join l, mid and r (in this order) descending along the spine of the heavier side
+            node_type *join(node_type *l, node_type *mid, node_type *r){
+                auto lz = l?l->size:0, rz = r?r->size:0;
+                if(lz > 3*rz+1){
+                    augment::push_down(l);
+                    link_right(l, join(l->right, mid, r));
+                    l->size = lz + rz + 1;
+                    augment::pull(l);
+                    return matain(l);
+                }
+                if(rz > 3*lz+1){
+                    augment::push_down(r);
+                    link_left(r, join(l, mid, r->left));
+                    r->size = lz + rz + 1;
+                    augment::pull(r);
+                    return matain(r);
+                }
+
+                link_left(mid, l);
+                link_right(mid, r);
+                mid->size = lz + rz + 1;
+                augment::pull(mid);
+                return mid;
             }
 
-            const value_type &operator[](size_t pos)const{
-                check(pos, size());
-                auto nd = search_node(root, pos);
-                return nd->val;
+            //join two trees, the first node of r becomes the joining node
+            node_type *join(node_type *l, node_type *r){
+                if(!l)
+                    return r;
+                if(!r)
+                    return l;
+
+                node_type *mid;
+                r = detach_front(r, mid);
+                return join(l, mid, r);
             }
 
-            value_type &back(){
-                return const_cast<value_type&>(
-                                    const_cast<const he_list *const>(this)->back());
+            node_type *detach_front(node_type *cur, node_type *&out){
+                augment::push_down(cur);
+                if(!cur->left){
+                    out = cur;
+                    return cur->right;
+                }
+
+                link_left(cur, detach_front(cur->left, out));
+                --cur->size;
+                augment::pull(cur);
+                return cur;
             }
 
-            const value_type &back()const{
-                check(0,size());
-                auto cur = root;
-                while(cur->right)
-                    cur = cur->right;
+            //l receives the first pos nodes of cur, r the rest
+            void split_node(node_type *cur, size_t pos, node_type *&l, node_type *&r){
+                if(!cur){
+                    l = r = nullptr;
+                    return;
+                }
 
-                return cur->val; 
+                augment::push_down(cur);
+                auto lc = cur->left, rc = cur->right;
+                auto lsz = lc?lc->size:0;
+                if(pos <= lsz){
+                    split_node(lc, pos, l, r);
+                    r = join(r, cur, rc);
+                }
+                else{
+                    split_node(rc, pos-lsz-1, l, r);
+                    l = join(lc, cur, l);
+                }
             }
 
-            value_type &front(){
-                return const_cast<value_type&>(
-                                    const_cast<const he_list *const>(this)->front());
+            //the freed nodes stay in the old arena for the lists still sharing it
+            void unshare(std::true_type){
+                if(alloc.unique())
+                    return;
+                flush();
+                he_list old(root(), alloc, header);
+                set_root(nullptr);
+                alloc = node_allocator();
+                append_range(std::make_move_iterator(old.begin()), std::make_move_iterator(old.end()));
+                Stats::freed(header, old.size());
             }
 
-            const value_type &front()const{
-                check(0,size());
-                auto cur = root;
-                while(cur->left)
-                    cur = cur->left;
-                
-                return cur->val;
+            void unshare(std::false_type){ }
+
+            //detach the tree of rhs so that it can be linked into this list
+            node_type *take_nodes(he_list &rhs){
+                auto r = rhs.root();
+                if(share_nodes(rhs, releasable<node_allocator>())){
+                    augment::merge(header, rhs.header);
+                    rhs.set_root(nullptr);
+                    return r;
+                }
+
+                //unrelated allocators: move the elements over
+                auto it = rhs.begin();
+                auto gen = [&it]()->value_type&&{
+                    auto &val = *it;
+                    ++it;
+                    return std::move(val);
+                };
+                r = build(rhs.size(), gen);
+                rhs.free_mem();
+                return r;
             }
 
-        public:
-            iterator begin(){
-                return iterator(root);
+            bool share_nodes(he_list &rhs, std::true_type){
+                if(!alloc.adopt(rhs.alloc) && !rhs.alloc.adopt(alloc))
+                    return false;
+                rhs.alloc.release();
+                return true;
             }
 
-            iterator end(){
-                return iterator();
+            bool share_nodes(he_list &rhs, std::false_type){
+                return alloc == rhs.alloc;
             }
 
-            const_iterator begin()const{
-                return const_iterator(root);
+            void free_mem(bool keep = false){
+                if(!root())
+                    return;
+
+                Stats::freed(header, size());
+                free_mem(keep, releasable<node_allocator>());
+                set_root(nullptr);
             }
 
-            const_iterator end()const{
-                return const_iterator();
+            //trivially destructible nodes in an unshared pool need no walk at all
+            void free_mem(bool keep, std::true_type){
+                if(!alloc.unique()){
+                    free_mem(keep, std::false_type());
+                    return;
+                }
+
+                if(!std::is_trivially_destructible<T>::value){
+                    //destruction leaves the pool alone, so it may run on many threads
+                    drop_all([this](node_type *nd){
+                        alloc_traits::destroy(alloc, nd);
+                    }, std::true_type());
+                }
+                if(keep)
+                    alloc.recycle();
+                else
+                    alloc.release();
             }
 
-            const_iterator cbegin()const{
-                return const_iterator(root);
+            //nodes go back one by one, a pool keeps them on its free list anyway
+            void free_mem(bool, std::false_type){
+                drop_all([this](node_type *nd){
+                    destroy_node(nd);
+                }, typename alloc_traits::is_always_equal());
             }
 
-            const_iterator cend()const{
-                return const_iterator();
+            template<typename F>
+            void drop_all(F fn, std::true_type){
+                if(root()->size < parallel_grain)
+                    drop_nodes(fn);
+                else
+                    par_drop(root(), fork_depth(0), fn);
             }
 
-        private:
-            void check(size_t pos, size_t range)const{
-                if(pos >= range)
-                    throw std::runtime_error("Out of range.");
+            template<typename F>
+            void drop_all(F fn, std::false_type){
+                drop_nodes(fn);
             }
 
-            template<typename V>
-            node_type *copy(const typename he_list<V>::node_type *cur){
+            //Post-order, the left subtrees of the top depth levels on their own threads. It
+            //runs in destructors, so a thread that cannot be started leaves the subtree to
+            //the calling thread instead of throwing.
+            template<typename F>
+            static void par_drop(node_type *cur, unsigned depth, F &fn){
                 if(!cur)
-                    return nullptr;
-                
-                auto nd = new node_type(cur->val);
-                nd->size = cur->size;
-                nd->left = copy<V>(cur->left);
-                nd->right = copy<V>(cur->right);
-                return nd;
-            } 
-
-            void free_mem(){
-                if(!root)
                     return;
 
-                std::stack<node_type*> stk;
-                stk.push(root);
-                while(!stk.empty()){
-                    auto cur = stk.top(); stk.pop();
-                    if(cur->right)
-                        stk.push(cur->right);
-                    if(cur->left) 
-                        stk.push(cur->left);
-                    delete cur;
+                std::future<void> left;
+                if(depth && cur->size >= parallel_grain)
+                    left = fork([&]{ par_drop(cur->left, depth-1, fn); });
+                if(left.valid()){
+                    par_drop(cur->right, depth-1, fn);
+                    left.get();
+                }
+                else{
+                    par_drop(cur->left, 0, fn);
+                    par_drop(cur->right, 0, fn);
+                }
+                fn(cur);
+            }
+
+            //post-order walk over the parent links, handing each node to fn after its children
+            template<typename F>
+            void drop_nodes(F fn){
+                auto cur = root();
+                while(cur){
+                    if(cur->left){
+                        cur = cur->left;
+                    }
+                    else if(cur->right){
+                        cur = cur->right;
+                    }
+                    else{
+                        auto p = cur->parent;
+                        if(p == &header){
+                            fn(cur);
+                            break;
+                        }
+
+                        auto pn = static_cast<node_type*>(p);
+                        if(pn->left == cur)
+                            pn->left = nullptr;
+                        else
+                            pn->right = nullptr;
+                        fn(cur);
+                        cur = pn;
+                    }
                 }
-                root = nullptr;
             }
 
             node_type *left_rotate(node_type *cur){
                 auto r = cur->right;
-                cur->right = r->left;
-                r->left = cur;
+                augment::push_down(cur);
+                augment::push_down(r);
+                link_right(cur, r->left);
+                r->parent = cur->parent;
+                link_left(r, cur);
                 r->size = cur->size;
-                cur->size = (cur->left?cur->left->size:0) + (cur->right?cur->right->size:0) + 1;
+                update(cur);
+                augment::pull(r);
                 return r;
             }
 
             node_type *right_rotate(node_type *cur){
                 auto l = cur->left;
-                cur->left = l->right;
-                l->right = cur;
+                augment::push_down(cur);
+                augment::push_down(l);
+                link_left(cur, l->right);
+                l->parent = cur->parent;
+                link_right(l, cur);
                 l->size = cur->size;
-                cur->size = (cur->left?cur->left->size:0) + (cur->right?cur->right->size:0) + 1;
+                update(cur);
+                augment::pull(l);
                 return l;
             }
 
@@ -292,114 +1670,166 @@ namespace stl{
                         rlz = rc&&rc->left?rc->left->size:0, rrz = rc&&rc->right?rc->right->size:0;
                     
                 if(llz > rz){   //LL
+                    Stats::rotated(header, he_list_rotation::ll);
                     cur = right_rotate(cur);
-                    cur->right = matain(cur->right);
+                    link_right(cur, matain(cur->right));
                     cur = matain(cur);
                 }
                 else if(lrz > rz){  //LR
-                    cur->left = left_rotate(cur->left);
+                    Stats::rotated(header, he_list_rotation::lr);
+                    link_left(cur, left_rotate(cur->left));
                     cur = right_rotate(cur);
-                    cur->left = matain(cur->left);
-                    cur->right = matain(cur->right);
+                    link_left(cur, matain(cur->left));
+                    link_right(cur, matain(cur->right));
                     cur = matain(cur);
                 }
                 else if(rrz > lz){  //RR
+                    Stats::rotated(header, he_list_rotation::rr);
                     cur = left_rotate(cur);
-                    cur->left = matain(cur->left);
+                    link_left(cur, matain(cur->left));
                     cur = matain(cur);
                 }
                 else if(rlz > lz){  //RL
-                    cur->right = right_rotate(cur->right);
+                    Stats::rotated(header, he_list_rotation::rl);
+                    link_right(cur, right_rotate(cur->right));
                     cur = left_rotate(cur);
-                    cur->left = matain(cur->left);
-                    cur->right = matain(cur->right);
+                    link_left(cur, matain(cur->left));
+                    link_right(cur, matain(cur->right));
                     cur = matain(cur);
                 }
 
                 return cur;
             }
 
-            node_type *add_node(node_type *cur, size_t pos, const value_type &val){   //pos从0开始
-                if(!cur) 
-                    return new node_type(val);
+            //node at pos, or the header for pos == size()
+            base_type *node_at(size_t pos){
+                if(pos == size())
+                    return &header;
+                return search_node(root(), pos);
+            }
 
-                auto lmsz = cur->size - (cur->right?cur->right->size:0);
-                if(pos < lmsz){
-                    cur->left = add_node(cur->left, pos, val);
+            //Link nd as the in-order predecessor of x (x may be the header), then climb
+            //the parent links back to the root. Each ancestor only grew on the side we
+            //came from, so only that side's two SBT conditions can break and matain runs
+            //just where one of them does. The sizes needed for the check are derived from
+            //the nodes on the path, so no sibling off the path is touched.
+            void insert_before(base_type *x, node_type *nd){
+                if(!x->left){
+                    x->left = nd;
+                    nd->parent = x;
                 }
                 else{
-                    cur->right = add_node(cur->right, pos-lmsz, val);
+                    auto p = x->left;
+                    augment::push_down(p);
+                    while(p->right){
+                        p = p->right;
+                        augment::push_down(p);
+                    }
+                    link_right(p, nd);
                 }
-                
-                ++cur->size;
-                return matain(cur);
-            }
 
-            node_type *add_node(node_type *cur, size_t pos, value_type &&val){   //pos从0开始
-                if(!cur) 
-                    return new node_type(std::move(val));
+                node_type *child = nd, *grand = nullptr;
+                for(auto p = nd->parent; p != &header; ){
+                    auto cur = static_cast<node_type*>(p);
+                    p = cur->parent;
+                    ++cur->size;
+                    augment::pull(cur);
+                    if(violated(cur, child, grand)){
+                        bool left = p->left == cur;
+                        cur = matain(cur);
+                        if(left){
+                            p->left = cur;
+                            cur->parent = p;
+                        }
+                        else{
+                            link_right(static_cast<node_type*>(p), cur);
+                        }
+                        grand = nullptr;    //children of a rotated node are hot, read them directly
+                    }
+                    else{
+                        grand = child;
+                    }
+                    child = cur;
+                }
+            }
 
-                auto lmsz = cur->size - (cur->right?cur->right->size:0);
-                if(pos < lmsz){
-                    cur->left = add_node(cur->left, pos, std::move(val));
+            //does a nephew outweigh the sibling of child? grand is the path node below child
+            static bool violated(const node_type *cur, const node_type *child, const node_type *grand){
+                size_t a, b;
+                if(grand){
+                    a = grand->size;
+                    b = child->size - 1 - a;
                 }
                 else{
-                    cur->right = add_node(cur->right, pos-lmsz, std::move(val));
+                    a = base_type::size_of(child->left);
+                    b = base_type::size_of(child->right);
                 }
-                
-                ++cur->size;
-                return matain(cur);
+
+                auto sibling = cur->size - 1 - child->size;
+                return a > sibling || b > sibling;
             }
 
-            node_type *erase_node(node_type *cur, size_t pos){
-                auto lsz = cur->left?cur->left->size:0, lmsz = lsz+1;
-                if(pos < lsz){
-                    cur->left = erase_node(cur->left, pos);
-                }
-                else if(pos < lmsz){
-                    auto lc = cur->left, rc = cur->right;
-                    if(!lc && !rc){
-                        delete cur;
-                        cur = nullptr;
+            //unlink and free x, returning its successor
+            //every node from the unlink point up to the root lost exactly one descendant
+            base_type *erase_at(node_type *x){
+                base_type *succ;
+                if(x->right){
+                    auto s = x->right;
+                    augment::push_down(s);
+                    while(s->left){
+                        s = s->left;
+                        augment::push_down(s);
                     }
-                    else if(!rc){
-                        delete cur;
-                        cur = lc;
-                    }
-                    else if(!lc){
-                        delete cur;
-                        cur = rc;
+                    succ = s;
+                }
+                else{
+                    succ = base_type::next(x);
+                }
+                base_type *fix;
+                if(!x->left || !x->right){
+                    replace(x, x->left?x->left:x->right);
+                    fix = x->parent;
+                }
+                else{
+                    auto s = static_cast<node_type*>(succ);
+                    if(s->parent != x){
+                        fix = s->parent;
+                        link_left(static_cast<node_type*>(s->parent), s->right);
+                        link_right(s, x->right);
                     }
                     else{
-                        node_type *pre = nullptr, *ml = rc;
-                        --ml->size;
-                        while(ml->left){
-                            pre = ml;
-                            ml = ml->left;
-                            -ml->size;
-                        }
-
-                        if(pre){
-                            pre->left = ml->right;
-                            ml->right = rc;
-                        }
-                        ml->left = cur->left;
-                        delete cur;
-                        cur = ml;
+                        fix = s;
                     }
+                    link_left(s, x->left);
+                    replace(x, s);
+                    s->size = x->size;
                 }
-                else{
-                    cur->right = erase_node(cur->right, pos-lmsz);
+
+                for(; fix != &header; fix = fix->parent){
+                    --fix->size;
+                    augment::pull(static_cast<node_type*>(fix));
                 }
 
-                if(cur)
-                    cur->size = (cur->left?cur->left->size:0) + (cur->right?cur->right->size:0) + 1;
+                delete_node(x);
+                return succ;
+            }
 
-                return cur;
+            //put c where x hangs below its parent
+            static void replace(node_type *x, node_type *c){
+                auto p = x->parent;
+                if(p->left == x)
+                    p->left = c;
+                else
+                    p->right = c;
+                if(c)
+                    c->parent = p;
             }
 
             node_type *search_node(node_type *cur, size_t pos)const{
+                size_t depth = 0;
                 while(cur){
+                    ++depth;
+                    augment::push_down(cur);
                     auto lsz = cur->left?cur->left->size:0, lmsz = lsz+1;
                     if(pos < lsz){
                         cur = cur->left;
@@ -413,77 +1843,157 @@ namespace stl{
                     }
                 }
 
+                Stats::searched(header, depth);
                 return cur;
             }
 
+            static size_t height_of(const node_type *cur){
+                if(!cur)
+                    return 0;
+                auto l = height_of(cur->left), r = height_of(cur->right);
+                return (l > r ? l : r) + 1;
+            }
+
         private:
-            node_type *root; 
+            header_type header;
+            node_allocator alloc;
         };
 
 
+        //Finger into a he_list remembering its node and position. Moving it by d positions
+        //climbs only as far as the target requires, so local access patterns cost O(log d)
+        //instead of a full descent from the root. insert and erase work in place.
+        //Modifying the list by other means than this cursor invalidates it.
+        template<typename T, typename Allocator, typename Augment, typename Stats>
+        class he_list<T, Allocator, Augment, Stats>::cursor{
+            friend class he_list;
 
-        template<typename T> bool operator==(const he_list_iterator<T> &, const he_list_iterator<T> &);
-        template<typename T> bool operator!=(const he_list_iterator<T> &, const he_list_iterator<T> &);
-        template<typename T> bool operator==(const he_list_iterator<T> &, const he_list_const_iterator<T> &);
-        template<typename T> bool operator==(const he_list_const_iterator<T> &, const he_list_iterator<T> &);
-        template<typename T> bool operator==(const he_list_const_iterator<T> &, const he_list_const_iterator<T> &);
-        template<typename T> bool operator!=(const he_list_iterator<T> &, const he_list_const_iterator<T> &);
-        template<typename T> bool operator!=(const he_list_const_iterator<T> &, const he_list_iterator<T> &);
-        template<typename T> bool operator!=(const he_list_const_iterator<T> &, const he_list_const_iterator<T> &);
+        public:
+            cursor():lst(nullptr), cur(nullptr), pos(0) { }
 
+        public:
+            size_t index()const{
+                return pos;
+            }
 
-        template<typename T>
+            bool at_end()const{
+                return cur == &lst->header;
+            }
+
+            T &operator*()const{
+                return static_cast<node_type*>(cur)->val;
+            }
+
+            T *operator->()const{
+                return &static_cast<node_type*>(cur)->val;
+            }
+
+            cursor &seek(size_t n){
+                lst->check(n, lst->size()+1);
+                cur = base_type::jump(cur, static_cast<long long>(n) - static_cast<long long>(pos));
+                pos = n;
+                return *this;
+            }
+
+            T &operator[](size_t n){
+                lst->check(n, lst->size());
+                return *seek(n);
+            }
+
+            cursor &operator++(){
+                cur = base_type::next(cur);
+                ++pos;
+                return *this;
+            }
+
+            cursor &operator--(){
+                cur = base_type::prev(cur);
+                --pos;
+                return *this;
+            }
+
+            //insert before the current element, the cursor moves onto the new element
+            void insert(const T &val){
+                auto nd = lst->new_node(val);
+                lst->insert_before(cur, nd);
+                cur = nd;
+            }
+
+            void insert(T &&val){
+                auto nd = lst->new_node(std::move(val));
+                lst->insert_before(cur, nd);
+                cur = nd;
+            }
+
+            //erase the current element, the cursor moves onto its successor
+            void erase(){
+                lst->check(pos, lst->size());
+                cur = lst->erase_at(static_cast<node_type*>(cur));
+            }
+
+        private:
+            cursor(he_list *l, base_type *x, size_t p):lst(l), cur(x), pos(p) { }
+
+        private:
+            he_list *lst;
+            base_type *cur;
+            size_t pos;
+        };
+
+
+
+        template<typename T, typename Augment> bool operator==(const he_list_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+        template<typename T, typename Augment> bool operator!=(const he_list_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+        template<typename T, typename Augment> bool operator==(const he_list_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+        template<typename T, typename Augment> bool operator==(const he_list_const_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+        template<typename T, typename Augment> bool operator==(const he_list_const_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+        template<typename T, typename Augment> bool operator!=(const he_list_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+        template<typename T, typename Augment> bool operator!=(const he_list_const_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+        template<typename T, typename Augment> bool operator!=(const he_list_const_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+
+
+        template<typename T, typename Augment>
         class he_list_iterator{
-            friend class he_list<T>;
-            friend bool operator==<T>(const he_list_iterator &, const he_list_iterator &);
-            friend bool operator!=<T>(const he_list_iterator &, const he_list_iterator &);
-            friend bool operator==<T>(const he_list_iterator<T> &, const he_list_const_iterator<T> &);
-            friend bool operator==<T>(const he_list_const_iterator<T> &, const he_list_iterator<T> &);
-            friend bool operator!=<T>(const he_list_iterator<T> &, const he_list_const_iterator<T> &);
-            friend bool operator!=<T>(const he_list_const_iterator<T> &, const he_list_iterator<T> &);
-            friend class he_list_const_iterator<T>;
+            template<typename V, typename A, typename G, typename S> friend class he_list;
+            friend bool operator==<T, Augment>(const he_list_iterator &, const he_list_iterator &);
+            friend bool operator!=<T, Augment>(const he_list_iterator &, const he_list_iterator &);
+            friend bool operator==<T, Augment>(const he_list_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+            friend bool operator==<T, Augment>(const he_list_const_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+            friend bool operator!=<T, Augment>(const he_list_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+            friend bool operator!=<T, Augment>(const he_list_const_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+            friend class he_list_const_iterator<T, Augment>;
+
+            using base_type = he_list_node_base<T, Augment>;
+            using node_type = he_list_node<T, Augment>;
 
         public:
-            using iterator_category = std::forward_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
             using value_type = T;
             using difference_type = std::ptrdiff_t;
             using pointer = T*;
             using reference = T&;
 
         public:
-            he_list_iterator() { }
+            he_list_iterator():cur(nullptr) { }
 
-            he_list_iterator(const he_list_iterator &rhs):stk(rhs.stk) { }
-
-            he_list_iterator(he_list_iterator &&rhs)noexcept:stk(std::move(rhs.stk)) { }
+            he_list_iterator(const he_list_iterator &rhs):cur(rhs.cur) { }
 
             he_list_iterator &operator=(const he_list_iterator &rhs){
-                stk = rhs.stk;
-                return *this;
-            }
-
-            he_list_iterator &operator=(he_list_iterator &&rhs)noexcept{
-                stk = std::move(rhs.stk);
+                cur = rhs.cur;
                 return *this;
             }
 
         public:
             T *operator->()const{
-                return &(stk.top()->val);
+                return &static_cast<node_type*>(cur)->val;
             }
 
             T &operator*()const{
-                return stk.top()->val;
+                return static_cast<node_type*>(cur)->val;
             }
 
             he_list_iterator &operator++(){
-                auto cur = stk.top(); stk.pop();
-                auto r = cur->right; 
-                while(r){
-                    stk.push(r);
-                    r = r->left;
-                }
-
+                cur = base_type::next(cur);
                 return *this;
             }
 
@@ -493,84 +2003,124 @@ namespace stl{
                 return ret;
             }
 
-        private:
-            he_list_iterator(typename he_list<T>::node_type* root){
-                while(root){
-                    stk.push(root);
-                    root = root->left;
-                }
+            he_list_iterator &operator--(){
+                cur = base_type::prev(cur);
+                return *this;
+            }
+
+            he_list_iterator operator--(int){
+                auto ret = *this;
+                operator--();
+                return ret;
+            }
+
+            he_list_iterator &operator+=(difference_type n){
+                cur = base_type::jump(cur, n);
+                return *this;
+            }
+
+            he_list_iterator &operator-=(difference_type n){
+                cur = base_type::jump(cur, -n);
+                return *this;
+            }
+
+            he_list_iterator operator+(difference_type n)const{
+                return he_list_iterator(base_type::jump(cur, n));
+            }
+
+            he_list_iterator operator-(difference_type n)const{
+                return he_list_iterator(base_type::jump(cur, -n));
+            }
+
+            T &operator[](difference_type n)const{
+                return *(*this + n);
+            }
+
+            //position of the element in the list, end() is at size()
+            unsigned long long index()const{
+                return base_type::rank(cur);
+            }
+
+            friend he_list_iterator operator+(difference_type n, const he_list_iterator &it){
+                return it + n;
+            }
+
+            friend difference_type operator-(const he_list_iterator &lhs, const he_list_iterator &rhs){
+                return difference_type(lhs.index()) - difference_type(rhs.index());
+            }
+
+            friend bool operator<(const he_list_iterator &lhs, const he_list_iterator &rhs){
+                return lhs.index() < rhs.index();
+            }
+
+            friend bool operator>(const he_list_iterator &lhs, const he_list_iterator &rhs){
+                return rhs < lhs;
+            }
+
+            friend bool operator<=(const he_list_iterator &lhs, const he_list_iterator &rhs){
+                return !(rhs < lhs);
+            }
+
+            friend bool operator>=(const he_list_iterator &lhs, const he_list_iterator &rhs){
+                return !(lhs < rhs);
             }
 
         private:
-            std::stack<typename he_list<T>::node_type*> stk;
+            explicit he_list_iterator(base_type *x):cur(x) { }
+
+        private:
+            base_type *cur;
         };
 
 
-        template<typename T>
+        template<typename T, typename Augment>
         class he_list_const_iterator{
-            friend class he_list<T>;
-            friend bool operator==<T>(const he_list_iterator<T> &, const he_list_const_iterator<T> &);
-            friend bool operator==<T>(const he_list_const_iterator<T> &, const he_list_iterator<T> &);
-            friend bool operator==<T>(const he_list_const_iterator<T> &, const he_list_const_iterator<T> &);
-            friend bool operator!=<T>(const he_list_iterator<T> &, const he_list_const_iterator<T> &);
-            friend bool operator!=<T>(const he_list_const_iterator<T> &, const he_list_iterator<T> &);
-            friend bool operator!=<T>(const he_list_const_iterator<T> &, const he_list_const_iterator<T> &);
+            template<typename V, typename A, typename G, typename S> friend class he_list;
+            friend bool operator==<T, Augment>(const he_list_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+            friend bool operator==<T, Augment>(const he_list_const_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+            friend bool operator==<T, Augment>(const he_list_const_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+            friend bool operator!=<T, Augment>(const he_list_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+            friend bool operator!=<T, Augment>(const he_list_const_iterator<T, Augment> &, const he_list_iterator<T, Augment> &);
+            friend bool operator!=<T, Augment>(const he_list_const_iterator<T, Augment> &, const he_list_const_iterator<T, Augment> &);
+
+            using base_type = he_list_node_base<T, Augment>;
+            using node_type = he_list_node<T, Augment>;
 
         public:
-            using iterator_category = std::forward_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
             using value_type = T;
             using difference_type = std::ptrdiff_t;
-            using pointer = T*;
-            using reference = T&;
+            using pointer = const T*;
+            using reference = const T&;
 
         public:
-            he_list_const_iterator() { }
-
-            he_list_const_iterator(const he_list_const_iterator &rhs):stk(rhs.stk) { }
+            he_list_const_iterator():cur(nullptr) { }
 
-            he_list_const_iterator(const he_list_iterator<T> &rhs):stk(rhs.stk) { }
+            he_list_const_iterator(const he_list_const_iterator &rhs):cur(rhs.cur) { }
 
-            he_list_const_iterator(he_list_const_iterator &&rhs)noexcept:stk(std::move(rhs.stk)) { }
-
-            he_list_const_iterator(he_list_iterator<T> &&rhs)noexcept:stk(std::move(rhs.stk)) { }
+            he_list_const_iterator(const he_list_iterator<T, Augment> &rhs):cur(rhs.cur) { }
 
             he_list_const_iterator &operator=(const he_list_const_iterator &rhs){
-                stk = rhs.stk;
-                return *this;
-            }
-
-            he_list_const_iterator &operator=(const he_list_iterator<T> &rhs){
-                stk = rhs.stk;
+                cur = rhs.cur;
                 return *this;
             }
 
-            he_list_const_iterator &operator=(he_list_const_iterator &&rhs)noexcept{
-                stk = std::move(rhs.stk);
-                return *this;
-            }
-
-            he_list_const_iterator &operator=(he_list_iterator<T> &&rhs)noexcept{
-                stk = std::move(rhs.stk);
+            he_list_const_iterator &operator=(const he_list_iterator<T, Augment> &rhs){
+                cur = rhs.cur;
                 return *this;
             }
 
         public:
             const T *operator->()const{
-                return &(stk.top()->val);
+                return &static_cast<const node_type*>(cur)->val;
             }
 
             const T &operator*()const{
-                return stk.top()->val;
+                return static_cast<const node_type*>(cur)->val;
             }
 
             he_list_const_iterator &operator++(){
-                auto cur = stk.top(); stk.pop();
-                auto r = cur->right; 
-                while(r){
-                    stk.push(r);
-                    r = r->left;
-                }
-
+                cur = base_type::next(cur);
                 return *this;
             }
 
@@ -580,57 +2130,114 @@ namespace stl{
                 return ret;
             }
 
-        private:
-            he_list_const_iterator(typename he_list<T>::node_type* root){
-                while(root){
-                    stk.push(root);
-                    root = root->left;
-                }
+            he_list_const_iterator &operator--(){
+                cur = base_type::prev(cur);
+                return *this;
+            }
+
+            he_list_const_iterator operator--(int){
+                auto ret = *this;
+                operator--();
+                return ret;
+            }
+
+            he_list_const_iterator &operator+=(difference_type n){
+                cur = base_type::jump(cur, n);
+                return *this;
+            }
+
+            he_list_const_iterator &operator-=(difference_type n){
+                cur = base_type::jump(cur, -n);
+                return *this;
+            }
+
+            he_list_const_iterator operator+(difference_type n)const{
+                return he_list_const_iterator(base_type::jump(cur, n));
+            }
+
+            he_list_const_iterator operator-(difference_type n)const{
+                return he_list_const_iterator(base_type::jump(cur, -n));
+            }
+
+            const T &operator[](difference_type n)const{
+                return *(*this + n);
+            }
+
+            //position of the element in the list, end() is at size()
+            unsigned long long index()const{
+                return base_type::rank(cur);
+            }
+
+            friend he_list_const_iterator operator+(difference_type n, const he_list_const_iterator &it){
+                return it + n;
+            }
+
+            friend difference_type operator-(const he_list_const_iterator &lhs, const he_list_const_iterator &rhs){
+                return difference_type(lhs.index()) - difference_type(rhs.index());
+            }
+
+            friend bool operator<(const he_list_const_iterator &lhs, const he_list_const_iterator &rhs){
+                return lhs.index() < rhs.index();
             }
 
+            friend bool operator>(const he_list_const_iterator &lhs, const he_list_const_iterator &rhs){
+                return rhs < lhs;
+            }
+
+            friend bool operator<=(const he_list_const_iterator &lhs, const he_list_const_iterator &rhs){
+                return !(rhs < lhs);
+            }
+
+            friend bool operator>=(const he_list_const_iterator &lhs, const he_list_const_iterator &rhs){
+                return !(lhs < rhs);
+            }
+
+        private:
+            explicit he_list_const_iterator(base_type *x):cur(x) { }
+
         private:
-            std::stack<typename he_list<T>::node_type*> stk;
+            base_type *cur;
         };
 
 
-        template<typename T>
-        bool operator==(const he_list_iterator<T> &lhs, const he_list_iterator<T> &rhs){
-            return lhs.stk == rhs.stk;
+        template<typename T, typename Augment>
+        bool operator==(const he_list_iterator<T, Augment> &lhs, const he_list_iterator<T, Augment> &rhs){
+            return lhs.cur == rhs.cur;
         }
 
-        template<typename T>
-        bool operator!=(const he_list_iterator<T> &lhs, const he_list_iterator<T> &rhs){
-            return lhs.stk != rhs.stk;
+        template<typename T, typename Augment>
+        bool operator!=(const he_list_iterator<T, Augment> &lhs, const he_list_iterator<T, Augment> &rhs){
+            return lhs.cur != rhs.cur;
         }
 
-        template<typename T>
-        bool operator==(const he_list_const_iterator<T> &lhs, const he_list_iterator<T> &rhs){
-            return lhs.stk == rhs.stk;
+        template<typename T, typename Augment>
+        bool operator==(const he_list_const_iterator<T, Augment> &lhs, const he_list_iterator<T, Augment> &rhs){
+            return lhs.cur == rhs.cur;
         }
 
-        template<typename T>
-        bool operator==(const he_list_iterator<T> &rhs, const he_list_const_iterator<T> &lhs){
-            return lhs.stk == rhs.stk;
+        template<typename T, typename Augment>
+        bool operator==(const he_list_iterator<T, Augment> &rhs, const he_list_const_iterator<T, Augment> &lhs){
+            return lhs.cur == rhs.cur;
         }
 
-        template<typename T>
-        bool operator==(const he_list_const_iterator<T> &rhs, const he_list_const_iterator<T> &lhs){
-            return lhs.stk == rhs.stk;
+        template<typename T, typename Augment>
+        bool operator==(const he_list_const_iterator<T, Augment> &rhs, const he_list_const_iterator<T, Augment> &lhs){
+            return lhs.cur == rhs.cur;
         }
 
-        template<typename T>
-        bool operator!=(const he_list_const_iterator<T> &lhs, const he_list_iterator<T> &rhs){
-            return lhs.stk != rhs.stk;
+        template<typename T, typename Augment>
+        bool operator!=(const he_list_const_iterator<T, Augment> &lhs, const he_list_iterator<T, Augment> &rhs){
+            return lhs.cur != rhs.cur;
         }
 
-        template<typename T>
-        bool operator!=(const he_list_iterator<T> &rhs, const he_list_const_iterator<T> &lhs){
-            return lhs.stk != rhs.stk;
+        template<typename T, typename Augment>
+        bool operator!=(const he_list_iterator<T, Augment> &rhs, const he_list_const_iterator<T, Augment> &lhs){
+            return lhs.cur != rhs.cur;
         }
 
-        template<typename T>
-        bool operator!=(const he_list_const_iterator<T> &rhs, const he_list_const_iterator<T> &lhs){
-            return lhs.stk != rhs.stk;
+        template<typename T, typename Augment>
+        bool operator!=(const he_list_const_iterator<T, Augment> &rhs, const he_list_const_iterator<T, Augment> &lhs){
+            return lhs.cur != rhs.cur;
         }
 
 
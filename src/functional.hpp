@@ -1,8 +1,12 @@
 #ifndef __FUNCTIONAL_HPP__
 #define __FUNCTIONAL_HPP__
 
-#include <utility>
+#include <cstddef>
 #include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace stl{
 
@@ -93,13 +97,15 @@ namespace stl{
         class function;
 
 
+        //The operations of a callable type live in one static table per type, so a
+        //function is two words: the table and the heap object.
         template<typename Res, typename... Args>
         class function<Res(Args...)>{
-            Res (*call_fptr)(function*, Args...);
-            void *(*clone_fptr)(const function*);
-            void (*destruct_fptr)(function*);
-        
-            void *callable_ptr;
+            struct vtable{
+                Res (*call)(function*, Args...);
+                void *(*clone)(const function*);
+                void (*destruct)(function*);
+            };
 
             template<typename Functor>
             static Res call(function *self, Args... args){
@@ -116,64 +122,58 @@ namespace stl{
                 delete static_cast<Functor*>(self->callable_ptr);
             }
 
+            template<typename Functor>
+            static constexpr vtable table{call<Functor>, clone<Functor>, destruct<Functor>};
+
+            const vtable *vt;
+            void *callable_ptr;
+
         public:
             constexpr function():
-                call_fptr(nullptr),
-                clone_fptr(nullptr),
-                destruct_fptr(nullptr),
+                vt(nullptr),
                 callable_ptr(nullptr){
             }
 
             ~function(){
-                destruct_fptr(this);
+                if(vt)
+                    vt->destruct(this);
             }
 
             template<typename F>
             function(F f):
-                call_fptr(call<F>),
-                clone_fptr(clone<F>),
-                destruct_fptr(destruct<F>),
-                callable_ptr(new F(f)) {
+                vt(&table<F>),
+                callable_ptr(new F(std::move(f))) {
             }
 
             function(const function &rhs):
-                call_fptr(rhs.call_fptr),
-                clone_fptr(rhs.clone_fptr),
-                destruct_fptr(rhs.destruct_fptr),
-                callable_ptr(clone_fptr(&rhs)) {
+                vt(rhs.vt),
+                callable_ptr(vt ? vt->clone(&rhs) : nullptr) {
             }
 
+            //the heap object changes hands, nothing is cloned or destroyed
             function(function &&rhs)noexcept:
-                call_fptr(rhs.call_fptr),
-                clone_fptr(rhs.clone_fptr),
-                destruct_fptr(rhs.destruct_fptr),
+                vt(rhs.vt),
                 callable_ptr(rhs.callable_ptr){
-                rhs.call_fptr = nullptr;
-                rhs.clone_fptr = nullptr;
-                rhs.destruct_fptr = nullptr;
+                rhs.vt = nullptr;
                 rhs.callable_ptr = nullptr;
             }
 
             function &operator=(const function &rhs){
-                auto tmp = rhs.clone_fptr(&rhs);
-                destruct_fptr(this);
+                auto tmp = rhs.vt ? rhs.vt->clone(&rhs) : nullptr;
+                if(vt)
+                    vt->destruct(this);
                 callable_ptr = tmp;
-                clone_fptr = rhs.clone_fptr;
-                call_fptr = rhs.call_fptr;
-                destruct_fptr = rhs.destruct_fptr;
+                vt = rhs.vt;
                 return *this;
             }
 
             function &operator=(function &&rhs)noexcept{
                 if(this != &rhs){
-                    destruct_fptr(this);
-                    call_fptr = rhs.call_fptr;
-                    clone_fptr = rhs.clone_fptr;
-                    destruct_fptr = rhs.destruct_fptr;
+                    if(vt)
+                        vt->destruct(this);
+                    vt = rhs.vt;
                     callable_ptr = rhs.callable_ptr;
-                    rhs.call_fptr = nullptr;
-                    rhs.clone_fptr = nullptr;
-                    rhs.destruct_fptr = nullptr;
+                    rhs.vt = nullptr;
                     rhs.callable_ptr = nullptr;
                 }
 
@@ -181,7 +181,7 @@ namespace stl{
             }
 
             Res operator()(Args... args){
-                return call_fptr(this, std::forward<Args>(args)...);
+                return vt->call(this, std::forward<Args>(args)...);
             }
         };
 
@@ -195,212 +195,440 @@ namespace stl{
         struct Placement{ };
 
 
-        template<typename Signature>
+        //room for three pointers: two captured pointers plus a size, a bound member function
+        //with its object, or a small lambda fit without touching the heap
+        constexpr std::size_t function_capacity = 3 * sizeof(void*);
+
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable>
+        class function_base;
+
+        template<typename Signature, std::size_t Capacity = function_capacity, std::size_t Align = alignof(void*)>
         class function;
 
+        template<typename Signature, std::size_t Capacity = function_capacity, std::size_t Align = alignof(void*)>
+        class unique_function;
 
-        template<typename Res, typename... Args> bool operator==(const function<Res(Args...)> &lhs, std::nullptr_t rhs)noexcept;
-        template<typename Res, typename... Args> bool operator==(std::nullptr_t lhs, const function<Res(Args...)> &rhs)noexcept;
-        template<typename Res, typename... Args> bool operator!=(const function<Res(Args...)> &lhs, std::nullptr_t rhs)noexcept;
-        template<typename Res, typename... Args> bool operator!=(std::nullptr_t lhs, const function<Res(Args...)> &rhs)noexcept;
 
-        template<typename Res, typename... Args>
-        class function<Res(Args...)>{
-            friend bool operator==<Res,Args...>(const function &lhs, std::nullptr_t rhs);
-            friend bool operator==<Res,Args...>(std::nullptr_t lhs, const function &rhs);
-            friend bool operator!=<Res,Args...>(const function &lhs, std::nullptr_t rhs);
-            friend bool operator!=<Res,Args...>(std::nullptr_t lhs, const function &rhs);
-
-            Res (*call_fptr)(function*, Args...);
-            void (*clone_fptr)(function *, const function*);
-            void (*destruct_fptr)(function*);
-        
-            void *callable_ptr;
+        template<typename Signature, std::size_t Capacity = function_capacity, std::size_t Align = alignof(void*)>
+        class inplace_function;
 
-            template<typename Functor>
-            static Res call(function *self, Args... args){
-                return (*static_cast<Functor*>(self->callable_ptr))(std::forward<Args>(args)...);
+        template<typename Signature>
+        class function_ref;
+
+
+        //call a member function pointer on an object or on a pointer to it
+        template<typename Res, typename F, typename Arg, typename... ArgTypes>
+        Res detail_call(F fptr, Arg &&obj, ArgTypes&&... args){
+            return (obj.*fptr)(std::forward<ArgTypes>(args)...);
+        }
+
+        template<typename Res, typename F, typename Arg, typename... ArgTypes>
+        Res detail_call(F fptr, Arg *obj, ArgTypes&&... args){
+            return (obj->*fptr)(std::forward<ArgTypes>(args)...);
+        }
+
+
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable> bool operator==(const function_base<Signature, Capacity, Align, Copyable> &lhs, std::nullptr_t rhs)noexcept;
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable> bool operator==(std::nullptr_t lhs, const function_base<Signature, Capacity, Align, Copyable> &rhs)noexcept;
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable> bool operator!=(const function_base<Signature, Capacity, Align, Copyable> &lhs, std::nullptr_t rhs)noexcept;
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable> bool operator!=(std::nullptr_t lhs, const function_base<Signature, Capacity, Align, Copyable> &rhs)noexcept;
+
+        //Type erasure shared by function and unique_function, which differ only in whether
+        //the callable can be cloned. A callable is stored inline when it fits into Capacity
+        //bytes at alignment Align and its move constructor cannot throw (so that moving
+        //stays noexcept); any other callable lives on the heap and the buffer holds a
+        //pointer to it.
+        template<typename Res, typename... Args, std::size_t Capacity, std::size_t Align, bool Copyable>
+        class function_base<Res(Args...), Capacity, Align, Copyable>{
+            static_assert(Capacity >= sizeof(void*) && Align >= alignof(void*) && !(Align & (Align-1)),
+                          "function needs an inline buffer that can hold a pointer.");
+
+            template<typename F>
+            using fits = Placement<(sizeof(F) <= Capacity && Align % alignof(F) == 0 &&
+                                    std::is_nothrow_move_constructible<F>::value)>;
+
+            //Operations of one callable type. relocate moves the callable into an empty
+            //function and ends it in the source; it is null when a byte copy of the buffer
+            //does the same, i.e. for heap-held and trivially copyable inline callables.
+            struct vtable{
+                Res (*call)(function_base*, Args...);
+                void (*relocate)(function_base*, function_base*);
+                void (*destruct)(function_base*);
+            };
+
+            //only copyable wrappers have a clone slot
+            struct copy_vtable : vtable{
+                void (*clone)(function_base*, const function_base*);
+            };
+
+            using ops_type = std::conditional_t<Copyable, copy_vtable, vtable>;
+
+            template<typename F>
+            using trivially_relocatable = std::integral_constant<bool,
+                                            !std::is_same<fits<F>, Placement<true>>::value || std::is_trivially_copyable<F>::value>;
+
+            const ops_type *vt;
+            alignas(Align) unsigned char storage[Capacity];
+
+            void *addr_of_callable(){
+                return storage;
             }
 
-            template<typename Class_,typename Arg,typename... ArgTypes>
-            static Res detail_call(function *self, Arg&& obj, ArgTypes&&... args){
-                typedef Res(Class_::*F)(ArgTypes...);
-                F fptr = nullptr;
-                std::memcpy(&fptr, self->callable_ptr, sizeof(F));
-                return (obj.*fptr)(std::forward<ArgTypes>(args)...);
+            const void *addr_of_callable()const{
+                return storage;
             }
 
-            template<typename Class_,typename Arg,typename... ArgTypes>
-            static Res detail_call(function *self, Arg *obj, ArgTypes&&... args){
-                typedef Res(Class_::*F)(ArgTypes...);
-                F fptr = nullptr;
-                std::memcpy(&fptr, self->callable_ptr, sizeof(F));
-                return (obj->*fptr)(std::forward<ArgTypes>(args)...);
+            void *heap_callable()const{
+                void *p;
+                std::memcpy(&p, storage, sizeof(p));
+                return p;
             }
 
-            template<typename Class_>
-            static Res mem_call(function *self, Args... args){
-                return detail_call<Class_>(self, std::forward<Args>(args)...);
+            void set_heap_callable(void *p){
+                std::memcpy(storage, &p, sizeof(p));
             }
 
             template<typename Functor>
-            static void clone(function *dst, function const *src){
-                dst->callable_ptr = new Functor(*static_cast<Functor*>(src->callable_ptr));
+            static Functor *callable(function_base *self, Placement<true>){
+                return std::launder(static_cast<Functor*>(self->addr_of_callable()));
             }
 
             template<typename Functor>
-            static void destruct(function *self){
-                delete static_cast<Functor*>(self->callable_ptr);
+            static Functor *callable(function_base *self, Placement<false>){
+                return static_cast<Functor*>(self->heap_callable());
+            }
+
+            template<typename Functor>
+            static Functor *callable(const function_base *self){
+                return callable<Functor>(const_cast<function_base*>(self), fits<Functor>());
+            }
+
+            template<typename Functor>
+            static Res call(function_base *self, Args... args){
+                return (*callable<Functor>(self))(std::forward<Args>(args)...);
+            }
+
+            template<typename F>
+            static Res mem_call(function_base *self, Args... args){
+                return detail_call<Res>(*callable<F>(self), std::forward<Args>(args)...);
             }
 
-            static void *addr_of_callable(function *f){
-                return &f->callable_ptr;
+            template<typename Functor>
+            static void clone(function_base *dst, const function_base *src){
+                dst->construct<Functor>(*callable<Functor>(src), fits<Functor>());
             }
 
-            static const void *addr_of_callable(const function *f){
-                return &f->callable_ptr;
+            template<typename Functor>
+            static void relocate(function_base *dst, function_base *src){
+                auto f = callable<Functor>(src);
+                new(dst->addr_of_callable()) Functor(std::move(*f));
+                f->~Functor();
             }
 
             template<typename Functor>
-            static Res call_placement(function *self, Args... args){
-                return (*static_cast<Functor*>(addr_of_callable(self)))(std::forward<Args>(args)...);
+            static void destruct(function_base *self){
+                destruct<Functor>(self, fits<Functor>());
             }
 
             template<typename Functor>
-            static void clone_placement(function *dst, const function *src){
-                new(addr_of_callable(dst)) Functor(*static_cast<const Functor*>(addr_of_callable(src)));
+            static void destruct(function_base *self, Placement<true>){
+                callable<Functor>(self)->~Functor();
             }
 
             template<typename Functor>
-            static void destruct_placement(function *self){
-                static_cast<Functor*>(addr_of_callable(self))->~Functor();
+            static void destruct(function_base *self, Placement<false>){
+                delete callable<Functor>(self);
+            }
+
+            template<typename F, typename V>
+            void construct(V &&f, Placement<true>){
+                new(addr_of_callable()) F(std::forward<V>(f));
+            }
+
+            template<typename F, typename V>
+            void construct(V &&f, Placement<false>){
+                set_heap_callable(new F(std::forward<V>(f)));
             }
 
             template<typename F>
-            void init(F f, Placement<false>){
-                call_fptr = call<F>;
-                clone_fptr = clone<F>;
-                destruct_fptr = destruct<F>;
-                callable_ptr = new F(f);
+            static constexpr auto caller_of(std::true_type){
+                return &mem_call<F>;
             }
 
             template<typename F>
-            void init(F f, Placement<true>){
-                call_fptr = call_placement<F>;
-                clone_fptr = clone_placement<F>;
-                destruct_fptr = destruct_placement<F>;
-                new (addr_of_callable(this)) F(f);
+            static constexpr auto caller_of(std::false_type){
+                return &call<F>;
             }
 
-        public:
-            constexpr function():
-                call_fptr(nullptr),
-                clone_fptr(nullptr),
-                destruct_fptr(nullptr),
-                callable_ptr(nullptr){
+            template<typename F>
+            static constexpr auto relocate_of(std::true_type){
+                return static_cast<void (*)(function_base*, function_base*)>(nullptr);
             }
 
-            ~function(){
-                if(destruct_fptr)
-                    destruct_fptr(this);
+            template<typename F>
+            static constexpr auto relocate_of(std::false_type){
+                return &relocate<F>;
             }
 
             template<typename F>
-            function(F f){
-                init(f, Placement<(sizeof(F) <= sizeof(callable_ptr))>());
+            static constexpr vtable table_of(std::false_type){
+                return {caller_of<F>(std::is_member_function_pointer<F>()), relocate_of<F>(trivially_relocatable<F>()), destruct<F>};
             }
 
-            template<typename Class_, typename... ArgTypes>
-            function(Res(Class_::*f)(ArgTypes...)){
-                call_fptr = mem_call<Class_>;
-                typedef  Res(Class_::*F)(ArgTypes...);
-                clone_fptr = clone<F>;
-                destruct_fptr = destruct<F>;
-                callable_ptr = new F(f);
+            template<typename F>
+            static constexpr copy_vtable table_of(std::true_type){
+                return {table_of<F>(std::false_type()), clone<F>};
             }
 
-            function(const function &rhs):
-                call_fptr(rhs.call_fptr),
-                clone_fptr(rhs.clone_fptr),
-                destruct_fptr(rhs.destruct_fptr),
-                callable_ptr(nullptr) {
-                if(clone_fptr)
-                    clone_fptr(callable_ptr, rhs.callable_ptr);
+            template<typename F>
+            static constexpr ops_type table = table_of<F>(std::integral_constant<bool, Copyable>());
+
+        protected:
+            constexpr function_base():
+                vt(nullptr),
+                storage(){
             }
 
-            function(function &&rhs)noexcept:
-                call_fptr(rhs.call_fptr),
-                clone_fptr(rhs.clone_fptr),
-                destruct_fptr(rhs.destruct_fptr),
-                callable_ptr(rhs.callable_ptr){
-                rhs.call_fptr = nullptr;
-                rhs.clone_fptr = nullptr;
-                rhs.destruct_fptr = nullptr;
-                rhs.callable_ptr = nullptr;
+            function_base(function_base &&rhs)noexcept:
+                function_base(){
+                take(rhs);
             }
 
-            function &operator=(const function &rhs){
-                function *tmp = nullptr;
-                if(rhs.clone_fptr)
-                    rhs.clone_fptr(tmp, &rhs);
-                if(destruct_fptr)
-                    destruct_fptr(this);
-                callable_ptr = tmp;
-                clone_fptr = rhs.clone_fptr;
-                call_fptr = rhs.call_fptr;
-                destruct_fptr = rhs.destruct_fptr;
+            function_base &operator=(function_base &&rhs)noexcept{
+                if(this != &rhs){
+                    clear();
+                    take(rhs);
+                }
+
                 return *this;
             }
 
-            function &operator=(function &&rhs)noexcept{
+            ~function_base(){
+                if(vt)
+                    vt->destruct(this);
+            }
+
+            //construct the callable straight from f, moving an rvalue instead of copying it
+            template<typename F, typename V>
+            void init(V &&f){
+                construct<F>(std::forward<V>(f), fits<F>());
+                vt = &table<F>;
+            }
+
+            void copy_from(const function_base &rhs){
+                if(rhs.vt)
+                    rhs.vt->clone(this, &rhs);
+                vt = rhs.vt;
+            }
+
+            void clear()noexcept{
+                if(vt)
+                    vt->destruct(this);
+                vt = nullptr;
+            }
+
+            void take(function_base &rhs)noexcept{
+                vt = rhs.vt;
+                if(!vt)
+                    return;
+                if(vt->relocate)
+                    vt->relocate(this, &rhs);
+                else
+                    std::memcpy(storage, rhs.storage, Capacity);
+                rhs.vt = nullptr;
+            }
+
+        public:
+            explicit operator bool()const noexcept{
+                return vt;
+            }
+
+            Res operator()(Args... args){
+                return vt->call(this, std::forward<Args>(args)...);
+            }
+        };
+
+
+        //Copyable wrapper of any copyable callable: functors, lambdas, function pointers
+        //and member function pointers (called with the object or a pointer to it first).
+        template<typename Res, typename... Args, std::size_t Capacity, std::size_t Align>
+        class function<Res(Args...), Capacity, Align> : public function_base<Res(Args...), Capacity, Align, true>{
+            using base_type = function_base<Res(Args...), Capacity, Align, true>;
+
+        public:
+            constexpr function() = default;
+
+            template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, function>::value>>
+            function(F &&f){
+                this->template init<std::decay_t<F>>(std::forward<F>(f));
+            }
+
+            function(const function &rhs):
+                base_type(){
+                this->copy_from(rhs);
+            }
+
+            function(function &&rhs)noexcept = default;
+
+            function &operator=(const function &rhs){
                 if(this != &rhs){
-                    if(destruct_fptr)
-                        destruct_fptr(this);
-                    call_fptr = rhs.call_fptr;
-                    clone_fptr = rhs.clone_fptr;
-                    destruct_fptr = rhs.destruct_fptr;
-                    callable_ptr = rhs.callable_ptr;
-                    rhs.call_fptr = nullptr;
-                    rhs.clone_fptr = nullptr;
-                    rhs.destruct_fptr = nullptr;
-                    rhs.callable_ptr = nullptr;
+                    function tmp(rhs);
+                    *this = std::move(tmp);
                 }
+                return *this;
+            }
+
+            function &operator=(function &&rhs)noexcept = default;
 
+            function &operator=(std::nullptr_t)noexcept{
+                this->clear();
                 return *this;
             }
+        };
+
+
+        //Move-only sibling of function for callables that cannot be copied, e.g. lambdas
+        //owning a std::unique_ptr or a std::promise.
+        template<typename Res, typename... Args, std::size_t Capacity, std::size_t Align>
+        class unique_function<Res(Args...), Capacity, Align> : public function_base<Res(Args...), Capacity, Align, false>{
+        public:
+            constexpr unique_function() = default;
+
+            template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, unique_function>::value>>
+            unique_function(F &&f){
+                this->template init<std::decay_t<F>>(std::forward<F>(f));
+            }
+
+            unique_function(unique_function &&rhs)noexcept = default;
+            unique_function &operator=(unique_function &&rhs)noexcept = default;
 
-            function &operator=(std::nullptr_t rhs)noexcept{
-                if(destruct_fptr)
-                    destruct_fptr(this);
-                call_fptr = nullptr;
-                clone_fptr = nullptr;
-                destruct_fptr = nullptr;
-                callable_ptr = nullptr;
+            unique_function &operator=(std::nullptr_t)noexcept{
+                this->clear();
                 return *this;
             }
+        };
 
-            Res operator()(Args... args){
-                return call_fptr(this, std::forward<Args>(args)...);
+        //Copyable wrapper that never allocates: every callable is stored in the inline
+        //buffer and one that does not fit is rejected at compile time. Callables must be
+        //nothrow move constructible, so moving never throws; a copy throws only if
+        //copying the callable does.
+        template<typename Res, typename... Args, std::size_t Capacity, std::size_t Align>
+        class inplace_function<Res(Args...), Capacity, Align> : public function_base<Res(Args...), Capacity, Align, true>{
+            using base_type = function_base<Res(Args...), Capacity, Align, true>;
+
+        public:
+            constexpr inplace_function() = default;
+
+            template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, inplace_function>::value>>
+            inplace_function(F &&f){
+                using D = std::decay_t<F>;
+                static_assert(sizeof(D) <= Capacity, "Callable is larger than the capacity of inplace_function.");
+                static_assert(Align % alignof(D) == 0, "Callable is more aligned than the buffer of inplace_function.");
+                static_assert(std::is_nothrow_move_constructible<D>::value, "inplace_function requires a nothrow move constructible callable.");
+                this->template init<D>(std::forward<F>(f));
+            }
+
+            inplace_function(const inplace_function &rhs):
+                base_type(){
+                this->copy_from(rhs);
+            }
+
+            inplace_function(inplace_function &&rhs)noexcept = default;
+
+            inplace_function &operator=(const inplace_function &rhs){
+                if(this != &rhs){
+                    inplace_function tmp(rhs);
+                    *this = std::move(tmp);
+                }
+                return *this;
+            }
+
+            inplace_function &operator=(inplace_function &&rhs)noexcept = default;
+
+            inplace_function &operator=(std::nullptr_t)noexcept{
+                this->clear();
+                return *this;
             }
         };
 
+
+        //Non-owning reference to a callable, for parameters that are only called during
+        //the call that receives them. Two words, trivially copyable and never allocating:
+        //function pointers are stored by value, any other callable (a lambda, a functor or
+        //a member function pointer) by address, so it must outlive the function_ref.
         template<typename Res, typename... Args>
-        bool operator==(const function<Res(Args...)> &lhs, std::nullptr_t rhs)noexcept{
-            return lhs.callable_ptr == rhs;
+        class function_ref<Res(Args...)>{
+            union target{
+                const void *obj;
+                void (*fn)();
+            };
+
+            template<typename F>
+            static Res call(target t, Args... args){
+                return (*static_cast<F*>(const_cast<void*>(t.obj)))(std::forward<Args>(args)...);
+            }
+
+            template<typename F>
+            static Res call_fn(target t, Args... args){
+                return reinterpret_cast<F>(t.fn)(std::forward<Args>(args)...);
+            }
+
+            template<typename F>
+            static Res mem_call(target t, Args... args){
+                return detail_call<Res>(*static_cast<const F*>(t.obj), std::forward<Args>(args)...);
+            }
+
+            template<typename F>
+            void bind(F &f, std::false_type, std::false_type){
+                t.obj = std::addressof(f);
+                thunk = call<F>;
+            }
+
+            template<typename F>
+            void bind(F &f, std::true_type, std::false_type){
+                t.fn = reinterpret_cast<void (*)()>(static_cast<std::decay_t<F>>(f));
+                thunk = call_fn<std::decay_t<F>>;
+            }
+
+            template<typename F>
+            void bind(F &f, std::false_type, std::true_type){
+                t.obj = std::addressof(f);
+                thunk = mem_call<std::remove_const_t<F>>;
+            }
+
+            target t;
+            Res (*thunk)(target, Args...);
+
+        public:
+            template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, function_ref>::value>>
+            function_ref(F &&f)noexcept{
+                using D = std::decay_t<F>;
+                bind(f, std::integral_constant<bool, std::is_pointer<D>::value && std::is_function<std::remove_pointer_t<D>>::value>(),
+                     std::is_member_function_pointer<D>());
+            }
+
+            Res operator()(Args... args)const{
+                return thunk(t, std::forward<Args>(args)...);
+            }
+        };
+
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable>
+        bool operator==(const function_base<Signature, Capacity, Align, Copyable> &lhs, std::nullptr_t)noexcept{
+            return !lhs;
         }
 
-        template<typename Res, typename... Args>
-        bool operator==(std::nullptr_t lhs, const function<Res(Args...)> &rhs)noexcept{
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable>
+        bool operator==(std::nullptr_t lhs, const function_base<Signature, Capacity, Align, Copyable> &rhs)noexcept{
             return rhs == lhs;
         }
 
-        template<typename Res, typename... Args>
-        bool operator!=(const function<Res(Args...)> &lhs, std::nullptr_t rhs)noexcept{
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable>
+        bool operator!=(const function_base<Signature, Capacity, Align, Copyable> &lhs, std::nullptr_t rhs)noexcept{
             return !(lhs == rhs);
         }
 
-        template<typename Res, typename... Args>
-        bool operator!=(std::nullptr_t lhs, const function<Res(Args...)> &rhs)noexcept{
+        template<typename Signature, std::size_t Capacity, std::size_t Align, bool Copyable>
+        bool operator!=(std::nullptr_t lhs, const function_base<Signature, Capacity, Align, Copyable> &rhs)noexcept{
             return !(lhs == rhs);
         }
 
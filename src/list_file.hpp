@@ -0,0 +1,233 @@
+#ifndef __LIST_FILE_HPP__
+#define __LIST_FILE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "efficient_list.hpp"
+
+namespace stl{
+
+    inline namespace version_0{
+
+
+        //Binary image of a sequence of trivially copyable elements: a 64 byte header
+        //followed by the elements in order, in the byte order of the writing machine.
+        //The in-order payload is all the shape information needed, a balanced tree is
+        //rebuilt from it in O(n) and a mapped file is indexed without any tree at all.
+        struct list_file_header{
+            char magic[8];
+            std::uint64_t count;
+            std::uint32_t elem_size;
+            std::uint32_t elem_align;
+            unsigned char reserved[40];
+        };
+
+        static_assert(sizeof(list_file_header) == 64, "list_file_header must stay 64 bytes.");
+
+        constexpr char list_file_magic[8] = {'H', 'E', 'L', 'I', 'S', 'T', '0', '1'};
+
+
+        template<typename T>
+        list_file_header make_list_file_header(std::uint64_t n){
+            list_file_header h{};
+            std::memcpy(h.magic, list_file_magic, sizeof(h.magic));
+            h.count = n;
+            h.elem_size = sizeof(T);
+            h.elem_align = alignof(T);
+            return h;
+        }
+
+        template<typename T>
+        void check_list_file_header(const list_file_header &h, std::uint64_t bytes){
+            if(std::memcmp(h.magic, list_file_magic, sizeof(h.magic)) || h.elem_size != sizeof(T) ||
+                    h.elem_align != alignof(T) || (bytes - sizeof(h)) / sizeof(T) < h.count)
+                throw std::runtime_error("Bad list file.");
+        }
+
+
+        //write the elements of lst to path, replacing the file
+        template<typename T, typename Allocator, typename Augment, typename Stats>
+        void save_list(const he_list<T, Allocator, Augment, Stats> &lst, const char *path){
+            static_assert(std::is_trivially_copyable<T>::value, "save_list requires trivially copyable elements.");
+            static_assert(alignof(T) <= sizeof(list_file_header), "Element alignment exceeds the file header.");
+
+            std::unique_ptr<std::FILE, int(*)(std::FILE*)> f(std::fopen(path, "wb"), &std::fclose);
+            if(!f)
+                throw std::runtime_error("Cannot open file.");
+
+            auto h = make_list_file_header<T>(lst.size());
+            bool ok = std::fwrite(&h, sizeof(h), 1, f.get()) == 1;
+
+            //elements are gathered into blocks, one fwrite per block
+            constexpr std::size_t block = (1 << 20) / sizeof(T) + 1;
+            std::vector<T> buf;
+            buf.reserve(block);
+            for(auto it = lst.begin(); ok && it != lst.end(); ++it){
+                buf.push_back(*it);
+                if(buf.size() == block){
+                    ok = std::fwrite(buf.data(), sizeof(T), buf.size(), f.get()) == buf.size();
+                    buf.clear();
+                }
+            }
+            if(ok && !buf.empty())
+                ok = std::fwrite(buf.data(), sizeof(T), buf.size(), f.get()) == buf.size();
+
+            if(std::fclose(f.release()) || !ok)
+                throw std::runtime_error("Cannot write file.");
+        }
+
+
+        //Read-only view of a list file mapped into memory. operator[] and iteration are
+        //served straight from the mapped pages, nothing is copied or deserialized.
+        template<typename T>
+        class mapped_list{
+            static_assert(std::is_trivially_copyable<T>::value, "mapped_list requires trivially copyable elements.");
+            static_assert(alignof(T) <= sizeof(list_file_header), "Element alignment exceeds the file header.");
+
+        public:
+            using value_type = T;
+            using size_t = unsigned long long;
+            using const_iterator = const T*;
+            using iterator = const_iterator;
+
+        public:
+            mapped_list()noexcept:base(nullptr), bytes(0), elems(nullptr), n(0){ }
+
+            explicit mapped_list(const char *path):
+                mapped_list(){
+                int fd = ::open(path, O_RDONLY);
+                if(fd < 0)
+                    throw std::runtime_error("Cannot open file.");
+
+                struct stat st;
+                if(::fstat(fd, &st) || std::uint64_t(st.st_size) < sizeof(list_file_header)){
+                    ::close(fd);
+                    throw std::runtime_error("Bad list file.");
+                }
+
+                auto mem = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if(mem == MAP_FAILED)
+                    throw std::runtime_error("Cannot map file.");
+
+                base = mem;
+                bytes = st.st_size;
+                auto &h = *static_cast<const list_file_header*>(base);
+                try{
+                    check_list_file_header<T>(h, bytes);
+                }
+                catch(...){
+                    ::munmap(base, bytes);
+                    throw;
+                }
+                elems = reinterpret_cast<const T*>(static_cast<const unsigned char*>(base) + sizeof(h));
+                n = h.count;
+            }
+
+            mapped_list(mapped_list &&rhs)noexcept:
+                mapped_list(){
+                swap(rhs);
+            }
+
+            mapped_list &operator=(mapped_list &&rhs)noexcept{
+                mapped_list tmp(std::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+
+            mapped_list(const mapped_list &) = delete;
+            mapped_list &operator=(const mapped_list &) = delete;
+
+            ~mapped_list(){
+                if(base)
+                    ::munmap(base, bytes);
+            }
+
+            void swap(mapped_list &rhs)noexcept{
+                std::swap(base, rhs.base);
+                std::swap(bytes, rhs.bytes);
+                std::swap(elems, rhs.elems);
+                std::swap(n, rhs.n);
+            }
+
+        public:
+            size_t size()const noexcept{
+                return n;
+            }
+
+            bool empty()const noexcept{
+                return !n;
+            }
+
+            const value_type &operator[](size_t pos)const{
+                return elems[pos];
+            }
+
+            const value_type &at(size_t pos)const{
+                if(pos >= n)
+                    throw std::runtime_error("Out of range.");
+                return elems[pos];
+            }
+
+            const value_type &front()const{
+                return at(0);
+            }
+
+            const value_type &back()const{
+                return at(n-1);
+            }
+
+            const value_type *data()const noexcept{
+                return elems;
+            }
+
+            const_iterator begin()const noexcept{
+                return elems;
+            }
+
+            const_iterator end()const noexcept{
+                return elems + n;
+            }
+
+            //hint the kernel about the coming access pattern, e.g. MADV_SEQUENTIAL
+            void advise(int advice)const noexcept{
+                if(base)
+                    ::madvise(base, bytes, advice);
+            }
+
+        private:
+            void *base;
+            std::size_t bytes;
+            const T *elems;
+            size_t n;
+        };
+
+
+        //Rebuild a list saved by save_list. The file is mapped and the balanced tree is
+        //built from the in-order payload in O(n), without any rebalancing.
+        template<typename T, typename Allocator = node_pool<T>, typename Augment = he_list_plain, typename Stats = he_list_no_stats>
+        he_list<T, Allocator, Augment, Stats> load_list(const char *path){
+            mapped_list<T> file(path);
+            file.advise(MADV_SEQUENTIAL);
+            return he_list<T, Allocator, Augment, Stats>(file.begin(), file.end());
+        }
+
+
+    }   //!version_0
+
+
+}   //!stl
+
+
+#endif  //!__LIST_FILE_HPP__
@@ -0,0 +1,294 @@
+#ifndef __NODE_POOL_HPP__
+#define __NODE_POOL_HPP__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace stl{
+
+    inline namespace version_0{
+
+
+        //Slab pool for fixed-size nodes.
+        //Objects are carved out of large contiguous chunks, freed objects go to an intrusive
+        //free list, release() drops every chunk at once and recycle() keeps them all for
+        //the objects allocated next. A node_pool is a handle to an
+        //arena: copies share the arena, while containers get a fresh arena on copy
+        //construction. An arena is not thread-safe; every handle to it must be used from
+        //one thread, and its memory lives until the last handle is gone. he_list shares
+        //an arena between lists built from another list's get_allocator() and between
+        //the parts of a split until he_list::unshare().
+        template<typename T>
+        class node_pool{
+            template<typename U> friend class node_pool;
+
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using propagate_on_container_copy_assignment = std::false_type;
+            using propagate_on_container_move_assignment = std::true_type;
+            using propagate_on_container_swap = std::true_type;
+            using is_always_equal = std::false_type;
+
+            template<typename U>
+            struct rebind{
+                using other = node_pool<U>;
+            };
+
+            static constexpr size_type min_chunk = 64;
+            static constexpr size_type max_chunk = 64 * 1024;
+
+        private:
+            union slot{
+                slot *next;
+                alignas(T) unsigned char storage[sizeof(T)];
+            };
+
+            struct chunk{
+                chunk *next;
+                size_type capacity;
+            };
+
+            struct arena{
+                chunk *chunks = nullptr;
+                chunk *chunks_tail = nullptr;
+                chunk *spare = nullptr;
+                slot *free_list = nullptr;
+                slot *free_tail = nullptr;
+                slot *cur = nullptr;
+                slot *last = nullptr;
+                size_type next_capacity = min_chunk;
+                size_type refs = 1;
+            };
+
+            static constexpr size_type alignment = alignof(slot) > alignof(chunk) ? alignof(slot) : alignof(chunk);
+            static constexpr size_type header = (sizeof(chunk) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+
+        public:
+            node_pool()noexcept:ar(nullptr){ }
+
+            node_pool(const node_pool &rhs)noexcept:ar(rhs.ar){
+                if(ar)
+                    ++ar->refs;
+            }
+
+            //A rebound pool hands out a different slot size and therefore starts empty and
+            //compares unequal to rhs; containers expose the rebound pool of their nodes.
+            template<typename U>
+            node_pool(const node_pool<U> &)noexcept:
+                node_pool() { }
+
+            node_pool(node_pool &&rhs)noexcept:ar(rhs.ar){
+                rhs.ar = nullptr;
+            }
+
+            node_pool &operator=(const node_pool &rhs)noexcept{
+                node_pool tmp(rhs);
+                swap(tmp);
+                return *this;
+            }
+
+            node_pool &operator=(node_pool &&rhs)noexcept{
+                if(this != &rhs){
+                    release();
+                    swap(rhs);
+                }
+
+                return *this;
+            }
+
+            ~node_pool(){
+                release();
+            }
+
+            node_pool select_on_container_copy_construction()const{
+                return node_pool();
+            }
+
+            void swap(node_pool &rhs)noexcept{
+                std::swap(ar, rhs.ar);
+            }
+
+            bool operator==(const node_pool &rhs)const noexcept{
+                return ar == rhs.ar;
+            }
+
+            bool operator!=(const node_pool &rhs)const noexcept{
+                return ar != rhs.ar;
+            }
+
+        public:
+            T *allocate(size_type n){
+                if(!ar)
+                    ar = new arena;
+
+                if(n == 1 && ar->free_list){
+                    auto s = ar->free_list;
+                    ar->free_list = s->next;
+                    if(!ar->free_list)
+                        ar->free_tail = nullptr;
+                    return reinterpret_cast<T*>(s);
+                }
+
+                if(size_type(ar->last - ar->cur) < n){
+                    if(n > 1){
+                        //dedicated chunk for bulk requests, the current bump region stays usable
+                        return reinterpret_cast<T*>(new_chunk(n));
+                    }
+
+                    if(ar->spare){
+                        reuse_chunk();
+                    }
+                    else{
+                        ar->cur = new_chunk(ar->next_capacity);
+                        ar->last = ar->cur + ar->next_capacity;
+                        if(ar->next_capacity < max_chunk)
+                            ar->next_capacity *= 2;
+                    }
+                }
+
+                auto s = ar->cur;
+                ar->cur += n;
+                return reinterpret_cast<T*>(s);
+            }
+
+            void deallocate(T *p, size_type n)noexcept{
+                auto s = reinterpret_cast<slot*>(p);
+                for(size_type i=0; i<n; ++i){
+                    s[i].next = ar->free_list;
+                    if(!ar->free_list)
+                        ar->free_tail = s + i;
+                    ar->free_list = s + i;
+                }
+            }
+
+            //true when no other handle can reach objects of this arena
+            bool unique()const noexcept{
+                return !ar || ar->refs == 1;
+            }
+
+            //Drop this handle. The last handle of an arena returns every chunk to the system,
+            //so all objects handed out by it must already be dead.
+            void release()noexcept{
+                if(ar && !--ar->refs){
+                    free_chunks(ar->chunks);
+                    free_chunks(ar->spare);
+                    delete ar;
+                }
+                ar = nullptr;
+            }
+
+            //Keep every chunk of the arena for the objects allocated next, so that a refill
+            //allocates no new memory. All objects handed out by the arena must already be
+            //dead and no other handle may share it.
+            void recycle()noexcept{
+                if(!ar)
+                    return;
+
+                if(ar->chunks){
+                    ar->chunks_tail->next = ar->spare;
+                    ar->spare = ar->chunks;
+                }
+                ar->chunks = ar->chunks_tail = nullptr;
+                ar->free_list = ar->free_tail = nullptr;
+                ar->cur = ar->last = nullptr;
+            }
+
+            //Take over the arena of rhs in O(1) so that objects allocated by rhs may be freed
+            //through *this; afterwards both handles share one arena. Fails if other handles
+            //still share the arena of rhs.
+            bool adopt(node_pool &rhs)noexcept{
+                if(ar == rhs.ar || !rhs.ar)
+                    return true;
+                if(rhs.ar->refs != 1)
+                    return false;
+                if(!ar){
+                    ar = rhs.ar;
+                    ++ar->refs;
+                    return true;
+                }
+
+                auto src = rhs.ar;
+                if(src->chunks){
+                    src->chunks_tail->next = ar->chunks;
+                    if(!ar->chunks)
+                        ar->chunks_tail = src->chunks_tail;
+                    ar->chunks = src->chunks;
+                }
+                while(src->spare){
+                    auto c = src->spare;
+                    src->spare = c->next;
+                    c->next = ar->spare;
+                    ar->spare = c;
+                }
+                if(src->free_list){
+                    src->free_tail->next = ar->free_list;
+                    if(!ar->free_list)
+                        ar->free_tail = src->free_tail;
+                    ar->free_list = src->free_list;
+                }
+                //keep the larger bump region, the other remainder stays unused until the arena dies
+                if(src->last - src->cur > ar->last - ar->cur){
+                    ar->cur = src->cur;
+                    ar->last = src->last;
+                }
+                if(src->next_capacity > ar->next_capacity)
+                    ar->next_capacity = src->next_capacity;
+
+                delete src;
+                rhs.ar = ar;
+                ++ar->refs;
+                return true;
+            }
+
+        private:
+            static void free_chunks(chunk *c)noexcept{
+                while(c){
+                    auto nxt = c->next;
+                    ::operator delete(static_cast<void*>(c), std::align_val_t(alignment));
+                    c = nxt;
+                }
+            }
+
+            static slot *slots_of(chunk *c)noexcept{
+                return reinterpret_cast<slot*>(reinterpret_cast<unsigned char*>(c) + header);
+            }
+
+            //continue bump allocation in the next spare chunk
+            void reuse_chunk()noexcept{
+                auto c = ar->spare;
+                ar->spare = c->next;
+                c->next = ar->chunks;
+                if(!ar->chunks)
+                    ar->chunks_tail = c;
+                ar->chunks = c;
+                ar->cur = slots_of(c);
+                ar->last = ar->cur + c->capacity;
+            }
+
+            slot *new_chunk(size_type n){
+                auto mem = ::operator new(header + n * sizeof(slot), std::align_val_t(alignment));
+                auto c = static_cast<chunk*>(mem);
+                c->next = ar->chunks;
+                c->capacity = n;
+                if(!ar->chunks)
+                    ar->chunks_tail = c;
+                ar->chunks = c;
+                return slots_of(c);
+            }
+
+        private:
+            arena *ar;
+        };
+
+
+    }   //!version_0
+
+
+}   //!stl
+
+
+#endif  //!__NODE_POOL_HPP__
@@ -0,0 +1,562 @@
+#ifndef __PERSISTENT_LIST_HPP__
+#define __PERSISTENT_LIST_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace stl{
+
+    inline namespace version_0{
+
+
+        template<typename T> class persistent_list_iterator;
+
+        //Nodes are shared between versions, so they have no parent link. A node with
+        //more than one reference is immutable; refs == 1 on a uniquely owned path
+        //means that the only version reaching it may change it in place.
+        template<typename U>
+        struct persistent_list_node{
+            persistent_list_node *left = nullptr;
+            persistent_list_node *right = nullptr;
+            unsigned long long size = 1;
+            std::atomic<std::size_t> refs{1};
+            U val;
+
+            template<typename... Args>
+            explicit persistent_list_node(Args&&... args):val(std::forward<Args>(args)...) { }
+        };
+
+        //Indexed sequence with the interface of he_list whose copies are O(1) snapshots.
+        //The size balanced tree is shared structurally between copies: a mutation copies
+        //the O(log n) nodes on its path that are still shared and updates unshared ones
+        //in place. Reference counts are atomic, so versions may be handed to (and destroyed
+        //on) other threads, but a single version must not be mutated concurrently.
+        template<typename T, typename Allocator = std::allocator<T>>
+        class persistent_list{
+        public:
+            using value_type = T;
+            using allocator_type = Allocator;
+            using size_t = unsigned long long;
+            using const_iterator = persistent_list_iterator<T>;
+            using iterator = const_iterator;
+
+        private:
+            using node_type = persistent_list_node<T>;
+            using alloc_traits = typename std::allocator_traits<Allocator>::template rebind_traits<node_type>;
+            using node_allocator = typename alloc_traits::allocator_type;
+
+        public:
+            persistent_list():root(nullptr){ }
+
+            explicit persistent_list(const Allocator &a):root(nullptr), alloc(a){ }
+
+            persistent_list(size_t n, const value_type &value = value_type{}):
+                persistent_list(){
+                auto gen = [&value]()->const value_type&{ return value; };
+                root = build(n, gen);
+            }
+
+            template<typename V>
+            persistent_list(std::initializer_list<V> lst):
+                persistent_list(lst.begin(), lst.end()){
+            }
+
+            template<typename Iterator, typename = std::enable_if_t<
+                                        std::is_convertible<
+                                                typename std::iterator_traits<Iterator>::iterator_category,
+                                                std::input_iterator_tag
+                                                    >::value
+                                                                    >
+                    >
+            persistent_list(Iterator beg, Iterator end):
+                persistent_list(){
+                append(beg, end, typename std::iterator_traits<Iterator>::iterator_category());
+            }
+
+            //O(1): both lists share every node until one of them changes
+            persistent_list(const persistent_list &rhs):
+                root(retain(rhs.root)), alloc(rhs.alloc){
+            }
+
+            persistent_list(persistent_list &&rhs)noexcept:
+                root(rhs.root), alloc(std::move(rhs.alloc)){
+                rhs.root = nullptr;
+            }
+
+            ~persistent_list(){
+                release(root);
+            }
+
+            persistent_list &operator=(const persistent_list &rhs){
+                persistent_list tmp(rhs);
+                return operator=(std::move(tmp));
+            }
+
+            persistent_list &operator=(persistent_list &&rhs)noexcept{
+                if(this != &rhs){
+                    std::swap(root, rhs.root);
+                    std::swap(alloc, rhs.alloc);
+                }
+
+                return *this;
+            }
+
+            allocator_type get_allocator()const{
+                return allocator_type(alloc);
+            }
+
+        public:
+            size_t size()const{
+                return size_of(root);
+            }
+
+            bool empty()const{
+                return !root;
+            }
+
+            void clear(){
+                release(root);
+                root = nullptr;
+            }
+
+        public:
+            //If a copy throws, the list is left as it was.
+            void insert(size_t pos, const value_type &val){
+                insert_new(pos, val);
+            }
+
+            void insert(size_t pos, value_type &&val){
+                insert_new(pos, std::move(val));
+            }
+
+            void erase(size_t pos){
+                check(pos, size());
+                own_path(root, pos, false);
+                erase_node(root, pos);
+            }
+
+            template<typename V>
+            void set(size_t pos, V &&val){
+                check(pos, size());
+                node_type **cur = &root;
+                for(;;){
+                    own(*cur);
+                    auto lsz = size_of((*cur)->left);
+                    if(pos < lsz){
+                        cur = &(*cur)->left;
+                    }
+                    else if(pos > lsz){
+                        pos -= lsz + 1;
+                        cur = &(*cur)->right;
+                    }
+                    else{
+                        break;
+                    }
+                }
+                (*cur)->val = std::forward<V>(val);
+            }
+
+            void push_back(const value_type &val){
+                insert(size(), val);
+            }
+
+            void push_back(value_type &&val){
+                insert(size(), std::move(val));
+            }
+
+            void pop_back(){
+                check(0, size());
+                erase(size()-1);
+            }
+
+            void push_front(const value_type &val){
+                insert(0, val);
+            }
+
+            void push_front(value_type &&val){
+                insert(0, std::move(val));
+            }
+
+            void pop_front(){
+                erase(0);
+            }
+
+        public:
+            //elements are shared with other versions and are only changed through set
+            const value_type &operator[](size_t pos)const{
+                check(pos, size());
+                auto cur = root;
+                for(;;){
+                    auto lsz = size_of(cur->left);
+                    if(pos < lsz){
+                        cur = cur->left;
+                    }
+                    else if(pos > lsz){
+                        pos -= lsz + 1;
+                        cur = cur->right;
+                    }
+                    else{
+                        return cur->val;
+                    }
+                }
+            }
+
+            const value_type &front()const{
+                return operator[](0);
+            }
+
+            const value_type &back()const{
+                check(0, size());
+                return operator[](size()-1);
+            }
+
+            const_iterator begin()const{
+                return const_iterator(root);
+            }
+
+            const_iterator end()const{
+                return const_iterator();
+            }
+
+            const_iterator cbegin()const{
+                return begin();
+            }
+
+            const_iterator cend()const{
+                return end();
+            }
+
+        private:
+            static size_t size_of(const node_type *nd){
+                return nd?nd->size:0;
+            }
+
+            static void update(node_type *cur){
+                cur->size = size_of(cur->left) + size_of(cur->right) + 1;
+            }
+
+            void check(size_t pos, size_t range)const{
+                if(pos >= range)
+                    throw std::runtime_error("Out of range.");
+            }
+
+            template<typename... Args>
+            node_type *new_node(Args&&... args){
+                auto nd = alloc_traits::allocate(alloc, 1);
+                try{
+                    alloc_traits::construct(alloc, nd, std::forward<Args>(args)...);
+                }
+                catch(...){
+                    alloc_traits::deallocate(alloc, nd, 1);
+                    throw;
+                }
+                return nd;
+            }
+
+            static node_type *retain(node_type *nd){
+                if(nd)
+                    nd->refs.fetch_add(1, std::memory_order_relaxed);
+                return nd;
+            }
+
+            //drop one reference, freeing the subtrees no other version reaches
+            void release(node_type *nd){
+                while(nd && nd->refs.fetch_sub(1, std::memory_order_acq_rel) == 1){
+                    release(nd->left);
+                    auto r = nd->right;
+                    alloc_traits::destroy(alloc, nd);
+                    alloc_traits::deallocate(alloc, nd, 1);
+                    nd = r;
+                }
+            }
+
+            //make the node at p private to this version, copying it if it is shared
+            void own(node_type *&p){
+                if(p->refs.load(std::memory_order_acquire) == 1)
+                    return;
+
+                auto nd = new_node(p->val);
+                nd->left = retain(p->left);
+                nd->right = retain(p->right);
+                nd->size = p->size;
+                release(p);
+                p = nd;
+            }
+
+            template<typename Iterator>
+            void append(Iterator beg, Iterator end, std::input_iterator_tag){
+                for(; beg != end; ++beg)
+                    push_back(*beg);
+            }
+
+            template<typename Iterator>
+            void append(Iterator beg, Iterator end, std::forward_iterator_tag){
+                auto gen = [&beg]()->typename std::iterator_traits<Iterator>::reference{ return *beg++; };
+                root = build(std::distance(beg, end), gen);
+            }
+
+            //In-order construction of a perfectly balanced tree from n generated values.
+            //If a value throws, the nodes built so far are freed before rethrowing.
+            template<typename Generator>
+            node_type *build(size_t n, Generator &gen){
+                if(!n)
+                    return nullptr;
+
+                auto lsz = (n-1) / 2;
+                auto l = build(lsz, gen);
+                node_type *nd;
+                try{
+                    nd = new_node(gen());
+                }
+                catch(...){
+                    release(l);
+                    throw;
+                }
+                nd->left = l;
+                try{
+                    nd->right = build(n-1-lsz, gen);
+                }
+                catch(...){
+                    release(nd);
+                    throw;
+                }
+                nd->size = n;
+                return nd;
+            }
+
+            //Copy the shared nodes on the way to pos (to the gap before pos for an insert,
+            //to the element and its successor for an erase). Copies are equal to the nodes
+            //they replace, so the list does not change if one throws, and the update that
+            //follows only relinks owned nodes.
+            void own_path(node_type *&top, size_t pos, bool gap){
+                node_type **cur = &top;
+                while(*cur){
+                    own(*cur);
+                    auto lsz = size_of((*cur)->left);
+                    if(pos < lsz || (gap && pos == lsz)){
+                        cur = &(*cur)->left;
+                    }
+                    else if(pos > lsz){
+                        pos -= lsz + 1;
+                        cur = &(*cur)->right;
+                    }
+                    else{
+                        if((*cur)->left && (*cur)->right)
+                            own_path((*cur)->right, 0, false);
+                        return;
+                    }
+                }
+            }
+
+            template<typename V>
+            void insert_new(size_t pos, V &&val){
+                check(pos, size()+1);
+                own_path(root, pos, true);
+                auto nd = new_node(std::forward<V>(val));
+                //Rotations may still copy shared siblings. The element is linked and all
+                //sizes are set before any rotation, and a rotation copies before it
+                //relinks, so a failed copy only leaves the tree less balanced.
+                try{
+                    insert_node(root, pos, nd);
+                }
+                catch(...){ }
+            }
+
+            void insert_node(node_type *&cur, size_t pos, node_type *nd){
+                if(!cur){
+                    cur = nd;
+                    return;
+                }
+
+                own(cur);
+                ++cur->size;
+                auto lsz = size_of(cur->left);
+                if(pos <= lsz)
+                    insert_node(cur->left, pos, nd);
+                else
+                    insert_node(cur->right, pos-lsz-1, nd);
+                matain(cur);
+            }
+
+            void erase_node(node_type *&cur, size_t pos){
+                own(cur);
+                auto lsz = size_of(cur->left);
+                if(pos < lsz){
+                    --cur->size;
+                    erase_node(cur->left, pos);
+                    return;
+                }
+                if(pos > lsz){
+                    --cur->size;
+                    erase_node(cur->right, pos-lsz-1);
+                    return;
+                }
+
+                auto old = cur;
+                if(!cur->left || !cur->right){
+                    cur = cur->left?cur->left:cur->right;
+                }
+                else{
+                    node_type *m;
+                    old->right = detach_front(old->right, m);
+                    m->left = old->left;
+                    m->right = old->right;
+                    m->size = old->size - 1;
+                    cur = m;
+                }
+                old->left = old->right = nullptr;
+                release(old);
+            }
+
+            node_type *detach_front(node_type *cur, node_type *&out){
+                own(cur);
+                if(!cur->left){
+                    out = cur;
+                    return cur->right;
+                }
+
+                cur->left = detach_front(cur->left, out);
+                --cur->size;
+                return cur;
+            }
+
+            //rotations relink owned nodes only, moving a link keeps its reference
+            void left_rotate(node_type *&cur){
+                own(cur->right);
+                auto r = cur->right;
+                cur->right = r->left;
+                r->left = cur;
+                r->size = cur->size;
+                update(cur);
+                cur = r;
+            }
+
+            void right_rotate(node_type *&cur){
+                own(cur->left);
+                auto l = cur->left;
+                cur->left = l->right;
+                l->right = cur;
+                l->size = cur->size;
+                update(cur);
+                cur = l;
+            }
+
+            void matain(node_type *&cur){
+                auto lc = cur->left, rc = cur->right;
+                auto lz = size_of(lc), rz = size_of(rc),
+                        llz = lc?size_of(lc->left):0, lrz = lc?size_of(lc->right):0,
+                        rlz = rc?size_of(rc->left):0, rrz = rc?size_of(rc->right):0;
+
+                if(llz > rz){   //LL
+                    right_rotate(cur);
+                    matain(cur->right);
+                    matain(cur);
+                }
+                else if(lrz > rz){  //LR
+                    own(cur->left);
+                    left_rotate(cur->left);
+                    right_rotate(cur);
+                    matain(cur->left);
+                    matain(cur->right);
+                    matain(cur);
+                }
+                else if(rrz > lz){  //RR
+                    left_rotate(cur);
+                    matain(cur->left);
+                    matain(cur);
+                }
+                else if(rlz > lz){  //RL
+                    own(cur->right);
+                    right_rotate(cur->right);
+                    left_rotate(cur);
+                    matain(cur->left);
+                    matain(cur->right);
+                    matain(cur);
+                }
+            }
+
+        private:
+            node_type *root;
+            node_allocator alloc;
+        };
+
+
+        //Forward iterator over one version, keeping the path to the current node.
+        //Changing that version invalidates it, other versions do not.
+        template<typename T>
+        class persistent_list_iterator{
+            template<typename V, typename A> friend class persistent_list;
+
+            using node_type = persistent_list_node<T>;
+
+            //a size balanced tree stays below 1.45 log2(n) + 1 levels for the largest n it ever held
+            static constexpr unsigned max_height = 96;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+        public:
+            persistent_list_iterator():depth(0) { }
+
+        public:
+            const T *operator->()const{
+                return &stk[depth-1]->val;
+            }
+
+            const T &operator*()const{
+                return stk[depth-1]->val;
+            }
+
+            persistent_list_iterator &operator++(){
+                auto cur = stk[--depth];
+                descend(cur->right);
+                return *this;
+            }
+
+            persistent_list_iterator operator++(int){
+                auto ret = *this;
+                operator++();
+                return ret;
+            }
+
+            friend bool operator==(const persistent_list_iterator &lhs, const persistent_list_iterator &rhs){
+                return lhs.depth == rhs.depth && (!lhs.depth || lhs.stk[lhs.depth-1] == rhs.stk[rhs.depth-1]);
+            }
+
+            friend bool operator!=(const persistent_list_iterator &lhs, const persistent_list_iterator &rhs){
+                return !(lhs == rhs);
+            }
+
+        private:
+            explicit persistent_list_iterator(node_type *root):depth(0){
+                descend(root);
+            }
+
+            void descend(node_type *cur){
+                for(; cur; cur = cur->left)
+                    stk[depth++] = cur;
+            }
+
+        private:
+            node_type *stk[max_height];
+            unsigned depth;
+        };
+
+
+    }   //!version_0
+
+
+}   //!stl
+
+
+#endif  //!__PERSISTENT_LIST_HPP__
@@ -0,0 +1,134 @@
+#include "chunked_list.hpp"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace{
+
+std::default_random_engine de(20260101);
+
+template<typename List, typename V>
+bool same(const List &lst, const std::vector<V> &ref){
+    if(lst.size() != ref.size())
+        return false;
+
+    std::size_t i = 0;
+    for(auto it = lst.begin(); it != lst.end(); ++it, ++i){
+        if(*it != ref[i] || lst[i] != ref[i])
+            return false;
+    }
+    for(auto it = lst.end(); it != lst.begin(); ){
+        if(*--it != ref[--i])
+            return false;
+    }
+    return i == 0;
+}
+
+}
+
+bool test_push_pop(){
+    stl::chunked_list<int, 8> lst;
+    std::vector<int> ref;
+    for(int i=0; i<5000; ++i){
+        lst.push_back(i);
+        lst.push_front(-i);
+        ref.push_back(i);
+        ref.insert(ref.begin(), -i);
+    }
+    if(!same(lst, ref))
+        return false;
+
+    while(!ref.empty()){
+        lst.pop_back();
+        ref.pop_back();
+        if(!ref.empty()){
+            lst.pop_front();
+            ref.erase(ref.begin());
+        }
+    }
+    return lst.empty() && lst.begin() == lst.end();
+}
+
+bool test_random_ops(){
+    stl::chunked_list<std::string, 4> lst;
+    std::vector<std::string> ref;
+    for(int r=0; r<40000; ++r){
+        if(ref.empty() || de() % 5 < 3){
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+            auto val = std::to_string(de() % 1000);
+            lst.insert(pos, val);
+            ref.insert(ref.begin() + pos, val);
+        }
+        else{
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size()-1)(de);
+            lst.erase(pos);
+            ref.erase(ref.begin() + pos);
+        }
+        if(r % 4000 == 0 && !same(lst, ref))
+            return false;
+    }
+
+    auto copied = lst;
+    stl::chunked_list<std::string, 4> moved(std::move(lst));
+    if(!same(copied, ref) || !same(moved, ref) || !lst.empty())
+        return false;
+
+    for(std::size_t r=0; !ref.empty(); ++r){
+        auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size()-1)(de);
+        moved.erase(pos);
+        ref.erase(ref.begin() + pos);
+        if(r % 1000 == 0 && !same(moved, ref))
+            return false;
+    }
+    return moved.empty() && moved.begin() == moved.end();
+}
+
+bool test_self_insert(){
+    //inserting an element of the list itself, within a leaf and across a leaf split
+    stl::chunked_list<std::string, 8> lst;
+    std::vector<std::string> ref;
+    for(auto s : {"aaa", "bbb", "ccc", "ddd", "eee"}){
+        lst.push_back(s);
+        ref.push_back(s);
+    }
+    for(int r=0; r<200; ++r){
+        auto from = std::uniform_int_distribution<std::size_t>(0, ref.size()-1)(de);
+        auto to = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        auto val = ref[from];
+        if(r % 3 == 0){
+            lst.push_back(lst[from]);
+            ref.push_back(val);
+        }
+        else if(r % 3 == 1){
+            lst.push_front(lst[from]);
+            ref.insert(ref.begin(), val);
+        }
+        else{
+            lst.insert(to, lst[from]);
+            ref.insert(ref.begin() + to, val);
+        }
+        if(!same(lst, ref))
+            return false;
+    }
+
+    stl::chunked_list<std::string, 8> five;
+    for(auto s : {"aaa", "bbb", "ccc", "ddd", "eee"})
+        five.push_back(s);
+    five.insert(0, five[3]);
+    return five[0] == "ddd" && five[4] == "ddd";
+}
+
+int main(){
+    std::cout<<"--------------test push pop start--------------"<<std::endl;
+    std::cout<<(test_push_pop()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test push pop end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test random ops start--------------"<<std::endl;
+    std::cout<<(test_random_ops()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test random ops end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test self insert start--------------"<<std::endl;
+    std::cout<<(test_self_insert()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test self insert end---------------"<<std::endl<<std::endl;
+}
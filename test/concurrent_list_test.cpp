@@ -0,0 +1,92 @@
+#include "concurrent_list.hpp"
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+bool test_pinned_version(){
+    stl::concurrent_list<int> lst;
+    for(int i=0; i<100; ++i)
+        lst.push_back(i);
+
+    auto rd = lst.make_reader();
+    {
+        auto v = rd.pin();
+        for(int i=0; i<100; ++i)
+            lst.set(i, -i);
+        lst.erase(0);
+        //the pinned version is not affected by later writes
+        for(int i=0; i<100; ++i){
+            if(v[i] != i)
+                return false;
+        }
+    }
+
+    auto v = rd.pin();
+    return v->size() == 99 && v[0] == -1 && v[98] == -99;
+}
+
+//readers check that every version they see is sorted and has the same size
+bool test_concurrent_readers(){
+    const int n = 2000, rounds = 20000;
+    stl::concurrent_list<int> lst;
+    lst.update([&](stl::concurrent_list<int>::version_type &v){
+        for(int i=0; i<n; ++i)
+            v.push_back(i * 100);
+    });
+
+    std::atomic<bool> done{false}, ok{true};
+    std::vector<std::thread> readers;
+    for(int t=0; t<4; ++t){
+        readers.emplace_back([&]{
+            auto rd = lst.make_reader();
+            while(!done.load()){
+                auto v = rd.pin();
+                if(v->size() != std::size_t(n)){
+                    ok = false;
+                    return;
+                }
+                int prev = -1;
+                for(auto x : *v){
+                    if(x < prev){
+                        ok = false;
+                        return;
+                    }
+                    prev = x;
+                }
+            }
+        });
+    }
+
+    std::default_random_engine de(20260103);
+    for(int r=0; r<rounds; ++r){
+        lst.update([&](stl::concurrent_list<int>::version_type &v){
+            v.erase(de() % v.size());
+            int val = int(de() % (n * 100));
+            std::size_t lo = 0, hi = v.size();
+            while(lo < hi){
+                auto mid = (lo + hi) / 2;
+                if(v[mid] < val)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            v.insert(lo, val);
+        });
+    }
+    done = true;
+    for(auto &t : readers)
+        t.join();
+    return ok;
+}
+
+int main(){
+    std::cout<<"--------------test pinned version start--------------"<<std::endl;
+    std::cout<<(test_pinned_version()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test pinned version end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test concurrent readers start--------------"<<std::endl;
+    std::cout<<(test_concurrent_readers()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test concurrent readers end---------------"<<std::endl<<std::endl;
+}
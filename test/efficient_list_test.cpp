@@ -5,6 +5,128 @@
 #include "efficient_list.hpp"
 #include <iostream>
 #include <sstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/sysinfo.h>
+#include <cerrno>
+
+//While set, the process claims eight cores and no thread can be started, so that
+//the parallel paths fork and every launch fails.
+static bool no_threads = false;
+
+extern "C" int get_nprocs(){
+    if(no_threads)
+        return 8;
+    auto real = reinterpret_cast<int(*)()>(dlsym(RTLD_NEXT, "get_nprocs"));
+    return real();
+}
+
+extern "C" int pthread_create(pthread_t *t, const pthread_attr_t *attr, void *(*fn)(void *), void *arg){
+    if(no_threads)
+        return EAGAIN;
+    auto real = reinterpret_cast<int(*)(pthread_t *, const pthread_attr_t *, void *(*)(void *), void *)>(dlsym(RTLD_NEXT, "pthread_create"));
+    return real(t, attr, fn, arg);
+}
+#else
+static bool no_threads = false;
+#endif
+
+namespace{
+
+std::default_random_engine de(20251231);
+
+template<typename List, typename V>
+bool same(const List &lst, const std::vector<V> &ref){
+    if(lst.size() != ref.size())
+        return false;
+
+    std::size_t i = 0;
+    for(auto it = lst.begin(); it != lst.end(); ++it, ++i){
+        if(*it != ref[i] || lst[i] != ref[i])
+            return false;
+    }
+    for(auto it = lst.end(); it != lst.begin(); ){
+        if(*--it != ref[--i])
+            return false;
+    }
+    return i == 0;
+}
+
+//appends a suffix to every element, composing suffixes in order
+struct append_suffix{
+    using action_type = std::string;
+    static action_type identity(){ return ""; }
+    static action_type compose(const action_type &f, const action_type &g){ return g + f; }
+    static void apply(const action_type &f, std::string &val){ val += f; }
+};
+
+//range sums under range additions
+struct sum_add{
+    using action_type = long long;
+    using aggregate_type = long long;
+    static action_type identity(){ return 0; }
+    static action_type compose(action_type f, action_type g){ return f + g; }
+    static void apply(action_type f, long long &val){ val += f; }
+    static aggregate_type unit(){ return 0; }
+    static aggregate_type lift(long long val){ return val; }
+    static aggregate_type combine(aggregate_type a, aggregate_type b){ return a + b; }
+    static void apply(action_type f, aggregate_type &agg, unsigned long long n){ agg += f * (long long)n; }
+};
+
+//concatenation, an aggregate whose order matters
+struct concat_all{
+    using aggregate_type = std::string;
+    static aggregate_type unit(){ return ""; }
+    static aggregate_type lift(const std::string &val){ return val + ","; }
+    static aggregate_type combine(const aggregate_type &a, const aggregate_type &b){ return a + b; }
+};
+
+//string whose copies throw once a budget is used up, counting the live instances
+struct fragile{
+    static int alive, budget;
+    std::string val;
+
+    fragile(const char *v):val(v){ ++alive; }
+    fragile(const fragile &rhs):val(rhs.val){
+        if(!budget--)
+            throw std::runtime_error("copy failed");
+        ++alive;
+    }
+    ~fragile(){ --alive; }
+};
+
+int fragile::alive = 0;
+int fragile::budget = 0;
+
+template<typename List, typename V>
+bool random_ops(List &lst, std::vector<V> &ref, int rounds){
+    for(int r=0; r<rounds; ++r){
+        if(ref.empty() || de() % 3){
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+            V val = V(std::to_string(de() % 1000));
+            lst.insert(pos, val);
+            ref.insert(ref.begin() + pos, val);
+        }
+        else{
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size()-1)(de);
+            lst.erase(pos);
+            ref.erase(ref.begin() + pos);
+        }
+    }
+    return same(lst, ref);
+}
+
+}
 
 void print(const stl::he_list<int> &lst) {
     if (lst.empty()) {
@@ -20,6 +142,687 @@ void print(const stl::he_list<int> &lst) {
     std::cout << std::endl;
 }
 
+bool test_allocators(){
+    stl::he_list<std::string> pooled;
+    stl::he_list<std::string, std::allocator<std::string>> global;
+    std::vector<std::string> ref1, ref2;
+    if(!random_ops(pooled, ref1, 5000) || !random_ops(global, ref2, 5000))
+        return false;
+
+    //get_allocator is the pool holding the nodes, a list built from it shares the arena
+    stl::he_list<std::string> sharing(pooled.get_allocator());
+    sharing.push_back("x");
+    if(sharing.get_allocator() != pooled.get_allocator() || stl::he_list<std::string>().get_allocator() == pooled.get_allocator())
+        return false;
+
+    //a list may also be declared with the node allocator itself
+    using node_alloc = stl::he_list<std::string>::allocator_type;
+    stl::he_list<std::string, node_alloc> direct(pooled.get_allocator());
+    direct.push_back("y");
+    if(direct.get_allocator() != pooled.get_allocator() || direct.front() != "y")
+        return false;
+
+    auto copied = pooled;
+    auto moved = std::move(global);
+    global = moved;
+    pooled = stl::he_list<std::string>();
+    return same(copied, ref1) && same(moved, ref2) && same(global, ref2) && pooled.empty() &&
+           copied.get_allocator() != sharing.get_allocator() && sharing.front() == "x";
+}
+
+bool test_bulk_build(){
+    for(std::size_t n=0; n<200; ++n){
+        std::vector<std::string> ref;
+        for(std::size_t i=0; i<n; ++i)
+            ref.push_back(std::to_string(i));
+
+        stl::he_list<std::string> lst(ref.begin(), ref.end());
+        if(!same(lst, ref) || !random_ops(lst, ref, 50))
+            return false;
+
+        std::vector<std::string> more(ref.begin(), ref.begin() + ref.size()/2);
+        lst.append_range(more.begin(), more.end());
+        ref.insert(ref.end(), more.begin(), more.end());
+        if(!same(lst, ref))
+            return false;
+    }
+
+    stl::he_list<int> filled(1000, 7);
+    if(!same(filled, std::vector<int>(1000, 7)))
+        return false;
+
+    std::istringstream in("1 2 3 4 5");
+    stl::he_list<int> streamed((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+    if(!same(streamed, std::vector<int>{1, 2, 3, 4, 5}))
+        return false;
+    streamed.assign(filled.begin(), filled.end());
+    return same(streamed, std::vector<int>(1000, 7));
+}
+
+bool test_split_concat(){
+    stl::he_list<std::string> lst;
+    std::vector<std::string> ref;
+    if(!random_ops(lst, ref, 2000))
+        return false;
+
+    for(int r=0; r<300; ++r){
+        auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        auto tail = lst.split(pos);
+        std::vector<std::string> ref_tail(ref.begin() + pos, ref.end());
+        ref.erase(ref.begin() + pos, ref.end());
+        if(!same(lst, ref) || !same(tail, ref_tail) || !random_ops(tail, ref_tail, 10))
+            return false;
+
+        stl::he_list<std::string> other;
+        std::vector<std::string> ref_other;
+        if(!random_ops(other, ref_other, 20))
+            return false;
+
+        pos = std::uniform_int_distribution<std::size_t>(0, ref_tail.size())(de);
+        tail.splice(pos, std::move(other));
+        ref_tail.insert(ref_tail.begin() + pos, ref_other.begin(), ref_other.end());
+        lst.concat(std::move(tail));
+        ref.insert(ref.end(), ref_tail.begin(), ref_tail.end());
+        if(!same(lst, ref) || !other.empty() || !tail.empty())
+            return false;
+    }
+
+    //the parts of a split share one arena until unshare(); then they may be used on
+    //different threads and freeing one part returns its memory
+    stl::he_list<int> big(std::size_t(100000), 1);
+    auto rest = big.split(1);
+    auto last = rest.split(rest.size()-1);
+    if(big.get_allocator() != rest.get_allocator() || rest.get_allocator() != last.get_allocator() ||
+       big.size() != 1 || rest.size() != 99998 || last.size() != 1)
+        return false;
+    big.concat(std::move(last));
+    big.unshare();
+    if(big.get_allocator() == rest.get_allocator() || big.get_allocator() == last.get_allocator() ||
+       big.size() != 2 || big.back() != 1)
+        return false;
+    std::thread worker([&big]{
+        for(int i=0; i<20000; ++i)
+            big.insert(big.size()/2, 2);
+    });
+    for(int i=0; i<20000; ++i)
+        rest.erase(rest.size()/2);
+    worker.join();
+    last.push_back(3);
+    if(big.size() != 20002 || rest.size() != 79998 || last.front() != 3)
+        return false;
+
+    //two arenas that are both shared elsewhere cannot merge, the elements move instead
+    stl::he_list<int> x(std::size_t(10), 4), y(std::size_t(10), 5);
+    auto x2 = x.split(5), y2 = y.split(5);
+    x2.concat(std::move(y2));
+    x.concat(std::move(y));
+    if(x.size() != 10 || x2.size() != 10 || x2[4] != 4 || x2[5] != 5 || x[5] != 5 || !y.empty() || !y2.empty())
+        return false;
+
+    stl::he_list<std::string, std::allocator<std::string>> a(ref.begin(), ref.end()), b(a);
+    auto c = a.split(a.size()/3);
+    a.concat(std::move(c));
+    a.splice(a.size()/2, std::move(b));
+    std::vector<std::string> twice(ref);
+    twice.insert(twice.begin() + ref.size()/2, ref.begin(), ref.end());
+    return same(a, twice);
+}
+
+bool test_bidirectional_iterator(){
+    std::vector<int> ref{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    stl::he_list<int> lst(ref.begin(), ref.end());
+    if(!std::equal(lst.begin(), lst.end(), ref.begin()) ||
+       !std::equal(std::make_reverse_iterator(lst.end()), std::make_reverse_iterator(lst.begin()), ref.rbegin()))
+        return false;
+
+    auto it = lst.begin();
+    auto cit = lst.cbegin();
+    std::advance(it, 4);
+    ++cit;
+    *it++ = 50;
+    stl::he_list<int>::const_iterator back = --lst.end();
+    return cit == std::next(lst.begin()) && *it == 6 && *--it == 50 && *it-- == 50 && *it == 4
+            && *back == 9 && std::prev(back) != back && sizeof(it) == sizeof(void*)
+            && std::distance(lst.cbegin(), lst.cend()) == 9;
+}
+
+bool test_random_access_iterator(){
+    std::vector<int> ref(1000);
+    for(auto &v : ref)
+        v = int(de() % 10000);
+
+    stl::he_list<int> lst(ref.begin(), ref.end());
+    for(int r=0; r<2000; ++r){
+        auto i = std::uniform_int_distribution<long long>(0, 1000)(de);
+        auto j = std::uniform_int_distribution<long long>(0, 1000)(de);
+        auto it = lst.begin() + i;
+        auto jt = it + (j - i);
+        if(it.index() != std::size_t(i) || jt - it != j - i || (jt == lst.end()) != (j == 1000)
+           || (j < 1000 && (*jt != ref[j] || lst.cbegin()[j] != ref[j])) || (i < j) != (it < jt))
+            return false;
+    }
+
+    std::sort(lst.begin(), lst.end());
+    std::sort(ref.begin(), ref.end());
+    auto lit = std::lower_bound(lst.cbegin(), lst.cend(), 5000);
+    auto rit = std::lower_bound(ref.begin(), ref.end(), 5000);
+    return same(lst, ref) && lit - lst.cbegin() == rit - ref.begin() && lst.end() - lst.begin() == 1000;
+}
+
+bool test_cursor(){
+    stl::he_list<std::string> lst;
+    std::vector<std::string> ref;
+    auto cur = lst.cursor_at(0);
+    for(int r=0; r<5000; ++r){
+        auto step = std::uniform_int_distribution<long long>(-3, 3)(de);
+        auto pos = std::min<long long>(std::max<long long>(0, cur.index() + step), ref.size());
+        cur.seek(pos);
+        if(!cur.at_end() && *cur != ref[pos])
+            return false;
+
+        if(ref.empty() || de() % 3){
+            auto val = std::to_string(de() % 1000);
+            cur.insert(val);
+            ref.insert(ref.begin() + pos, val);
+        }
+        else if(!cur.at_end()){
+            cur.erase();
+            ref.erase(ref.begin() + pos);
+        }
+        if(cur.index() != std::size_t(pos) || (!cur.at_end() && *cur != ref[pos]))
+            return false;
+    }
+
+    for(std::size_t i=0; i<ref.size(); i+=3){
+        if(cur[i] != ref[i] || lst.cursor_at(i)[i] != ref[i])
+            return false;
+    }
+    return same(lst, ref) && random_ops(lst, ref, 100);
+}
+
+bool test_lazy_range_ops(){
+    stl::he_list<std::string, stl::node_pool<std::string>, append_suffix> lst;
+    std::vector<std::string> ref;
+    if(!random_ops(lst, ref, 300))
+        return false;
+
+    for(int r=0; r<3000; ++r){
+        auto a = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        auto b = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        auto l = std::min(a, b), h = std::max(a, b);
+        switch(de() % 5){
+        case 0:
+            lst.reverse(l, h);
+            std::reverse(ref.begin() + l, ref.begin() + h);
+            break;
+        case 1:{
+            auto suffix = std::string(1, char('a' + de() % 26));
+            lst.apply(l, h, suffix);
+            for(auto i=l; i<h; ++i)
+                ref[i] += suffix;
+            break;
+        }
+        case 2:{
+            auto val = std::to_string(de() % 1000);
+            lst.assign(l, h, val);
+            std::fill(ref.begin() + l, ref.begin() + h, val);
+            break;
+        }
+        case 3:
+            if(!random_ops(lst, ref, 5))
+                return false;
+            break;
+        default:
+            if(!ref.empty() && (lst.front() != ref.front() || lst.back() != ref.back() || lst[l % ref.size()] != ref[l % ref.size()]))
+                return false;
+        }
+    }
+
+    auto copied = lst;
+    lst.reverse(0, lst.size());
+    auto tail = lst.split(lst.size() / 2);
+    tail.apply(0, tail.size(), std::string("!"));
+    lst.concat(std::move(tail));
+    std::reverse(ref.begin(), ref.end());
+    for(auto i=ref.size()/2; i<ref.size(); ++i)
+        ref[i] += "!";
+    if(!same(lst, ref))
+        return false;
+
+    std::reverse(ref.begin(), ref.end());
+    for(auto i=0; i<(int)ref.size()-(int)ref.size()/2; ++i)
+        ref[i].pop_back();
+    return same(copied, ref);
+}
+
+bool test_range_query(){
+    stl::he_list<std::string, stl::node_pool<std::string>, concat_all> strs;
+    std::vector<std::string> sref;
+    for(int r=0; r<50; ++r){
+        if(!random_ops(strs, sref, 40))
+            return false;
+
+        auto a = std::uniform_int_distribution<std::size_t>(0, sref.size())(de);
+        auto b = std::uniform_int_distribution<std::size_t>(0, sref.size())(de);
+        std::string expect;
+        for(auto i=std::min(a, b); i<std::max(a, b); ++i)
+            expect += sref[i] + ",";
+        if(strs.query(std::min(a, b), std::max(a, b)) != expect)
+            return false;
+    }
+    auto tail = strs.split(sref.size() / 3);
+    strs.concat(std::move(tail));
+    std::string all;
+    for(auto &v : sref)
+        all += v + ",";
+    if(strs.query(0, strs.size()) != all)
+        return false;
+
+    stl::he_list<long long, stl::node_pool<long long>, sum_add> nums;
+    std::vector<long long> ref;
+    for(int r=0; r<5000; ++r){
+        auto a = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        auto b = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        auto l = std::min(a, b), h = std::max(a, b);
+        long long v = de() % 1000;
+        switch(de() % 7){
+        case 0:
+            nums.apply(l, h, v);
+            for(auto i=l; i<h; ++i)
+                ref[i] += v;
+            break;
+        case 1:
+            nums.assign(l, h, v);
+            std::fill(ref.begin() + l, ref.begin() + h, v);
+            break;
+        case 2:
+            nums.reverse(l, h);
+            std::reverse(ref.begin() + l, ref.begin() + h);
+            break;
+        case 3:
+            if(!ref.empty()){
+                nums.set(l % ref.size(), v);
+                ref[l % ref.size()] = v;
+            }
+            break;
+        case 4:
+            nums.insert(a, v);
+            ref.insert(ref.begin() + a, v);
+            break;
+        case 5:
+            if(!ref.empty()){
+                nums.erase(l % ref.size());
+                ref.erase(ref.begin() + l % ref.size());
+            }
+            break;
+        default:{
+            long long expect = 0;
+            for(auto i=l; i<h; ++i)
+                expect += ref[i];
+            if(nums.query(l, h) != expect)
+                return false;
+        }
+        }
+    }
+    return same(nums, ref);
+}
+
+template<typename List>
+bool check_parallel(List &lst, std::vector<std::string> &ref){
+    lst.for_each([](std::string &val){ val += "a"; }, 4);
+    lst.transform([](const std::string &val){ return "b" + val; }, 3);
+    for(auto &v : ref)
+        v = "b" + v + "a";
+
+    std::vector<std::string> out(ref.size());
+    if(lst.copy_to(out.begin(), 4) != out.end() || out != ref)
+        return false;
+
+    std::size_t chars = 0;
+    for(auto &v : ref)
+        chars += v.size();
+    auto joined = lst.reduce(std::string(">"), [](const std::string &a, const std::string &b){ return a + b; }, 4);
+    std::size_t counted = 0;
+    const List &clst = lst;
+    clst.for_each([&counted](const std::string &){ ++counted; }, 1);
+    if(joined.size() != chars + 1 || joined.compare(1, ref[0].size(), ref[0]) != 0 || counted != ref.size())
+        return false;
+
+    List copied(lst);
+    return same(copied, ref);
+}
+
+bool test_parallel(){
+    std::vector<std::string> ref;
+    for(int i=0; i<100000; ++i)
+        ref.push_back(std::to_string(de() % 1000));
+
+    stl::he_list<std::string> pooled(ref.begin(), ref.end());
+    stl::he_list<std::string, std::allocator<std::string>> global(ref.begin(), ref.end());
+    auto ref2 = ref;
+    if(!check_parallel(pooled, ref) || !check_parallel(global, ref2))
+        return false;
+
+    stl::he_list<long long, stl::node_pool<long long>, sum_add> nums(std::size_t(70000), 1);
+    nums.transform([](long long v){ return v * 3; });
+    if(nums.query(0, nums.size()) != 210000 || nums.reduce(0LL, [](long long a, long long b){ return a + b; }) != 210000)
+        return false;
+
+    stl::he_list<int> empty;
+    return empty.reduce(7, [](int a, int b){ return a + b; }) == 7;
+}
+
+//counts how it was constructed
+struct tracked{
+    static int copies, moves;
+    int a;
+    std::string b;
+
+    tracked(int x, std::string y):a(x), b(std::move(y)) { }
+    tracked(const tracked &rhs):a(rhs.a), b(rhs.b) { ++copies; }
+    tracked(tracked &&rhs):a(rhs.a), b(std::move(rhs.b)) { ++moves; }
+    tracked &operator=(const tracked &) = default;
+};
+
+int tracked::copies = 0;
+int tracked::moves = 0;
+
+bool test_emplace_insert_range(){
+    stl::he_list<tracked> objs;
+    objs.emplace_back(2, "two");
+    objs.emplace_front(0, "zero");
+    auto &mid = objs.emplace(1, 1, "one");
+    if(tracked::copies || tracked::moves || mid.b != "one" || objs.size() != 3)
+        return false;
+    for(int i=0; i<3; ++i){
+        if(objs[i].a != i)
+            return false;
+    }
+
+    stl::he_list<std::string> lst;
+    std::vector<std::string> ref;
+    if(!random_ops(lst, ref, 500))
+        return false;
+    for(int r=0; r<200; ++r){
+        std::vector<std::string> src(de() % 50);
+        for(auto &v : src)
+            v = std::to_string(de() % 1000);
+        auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        if(r % 2){
+            lst.insert(pos, src.begin(), src.end());
+        }
+        else{
+            std::stringstream ss;
+            for(auto &v : src)
+                ss << v << ' ';
+            lst.insert(pos, std::istream_iterator<std::string>(ss), std::istream_iterator<std::string>());
+        }
+        ref.insert(ref.begin() + pos, src.begin(), src.end());
+    }
+    return same(lst, ref) && random_ops(lst, ref, 500);
+}
+
+bool test_erase_range_clear(){
+    stl::he_list<std::string> lst;
+    std::vector<std::string> ref;
+    for(int r=0; r<300; ++r){
+        if(!random_ops(lst, ref, 30))
+            return false;
+        auto a = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        auto b = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+        if(de() % 4 == 0)
+            b = a + std::min<std::size_t>(ref.size() - a, 3);
+        lst.erase(std::min(a, b), std::max(a, b));
+        ref.erase(ref.begin() + std::min(a, b), ref.begin() + std::max(a, b));
+    }
+    if(!same(lst, ref))
+        return false;
+
+    lst.erase(0, lst.size());
+    if(!lst.empty() || lst.begin() != lst.end())
+        return false;
+
+    //refill cycles on recycled memory, also with a second handle on the arena
+    for(int cycle=0; cycle<5; ++cycle){
+        ref.clear();
+        for(int i=0; i<3000; ++i){
+            lst.push_back(std::to_string(cycle * i));
+            ref.push_back(std::to_string(cycle * i));
+        }
+        if(!same(lst, ref))
+            return false;
+
+        auto part = lst.split(cycle * 100);
+        lst.concat(std::move(part));
+        if(cycle == 3){
+            auto shared = lst.split(10);
+            lst.clear(true);
+            if(shared.size() != ref.size() - 10)
+                return false;
+        }
+        lst.clear(true);
+    }
+
+    stl::he_list<std::string, std::allocator<std::string>> global(ref.begin(), ref.end());
+    global.erase(10, 2000);
+    ref.erase(ref.begin() + 10, ref.begin() + 2000);
+    if(!same(global, ref))
+        return false;
+    global.clear(true);
+    return global.empty();
+}
+
+bool test_freeze_thaw(){
+    std::vector<std::string> ref;
+    for(int i=0; i<100000; ++i)
+        ref.push_back(std::to_string(i * 7));
+    stl::he_list<std::string> lst(ref.begin(), ref.end());
+
+    auto frozen = lst.freeze(4);
+    if(!lst.empty() || frozen.size() != ref.size() || frozen.front() != ref.front() || frozen.back() != ref.back())
+        return false;
+    std::size_t i = 0;
+    for(auto &val : frozen){
+        if(val != ref[i] || frozen[i] != ref[i])
+            return false;
+        ++i;
+    }
+
+    lst.push_back("stale");
+    lst.thaw(std::move(frozen));
+    if(!frozen.empty() || !same(lst, ref))
+        return false;
+
+    //elements whose move may throw are moved serially
+    stl::he_list<tracked> objs;
+    for(int k=0; k<1000; ++k)
+        objs.emplace_back(k, std::to_string(k));
+    auto frozen_objs = objs.freeze();
+    for(int k=0; k<1000; ++k){
+        if(frozen_objs[k].a != k || frozen_objs[k].b != std::to_string(k))
+            return false;
+    }
+
+    //a thawed augmented list has its aggregates rebuilt
+    stl::he_list<long long, stl::node_pool<long long>, sum_add> nums(std::size_t(50000), 2);
+    nums.apply(0, 50000, 1);
+    auto frozen_nums = nums.freeze();
+    nums.thaw(std::move(frozen_nums));
+    return nums.query(100, 200) == 300 && nums.size() == 50000;
+}
+
+template<typename T>
+bool check_searches(const stl::he_list<T> &lst, const std::vector<T> &ref, const std::vector<T> &probes){
+    for(auto &val : probes){
+        auto pos = std::size_t(std::find(ref.begin(), ref.end(), val) - ref.begin());
+        if(lst.index_of(val) != pos || std::size_t(lst.find(val) - lst.begin()) != pos)
+            return false;
+        if(lst.count(val) != std::size_t(std::count(ref.begin(), ref.end(), val)))
+            return false;
+    }
+    return std::size_t(lst.min_element() - lst.begin()) == std::size_t(std::min_element(ref.begin(), ref.end()) - ref.begin()) &&
+           std::size_t(lst.max_element() - lst.begin()) == std::size_t(std::max_element(ref.begin(), ref.end()) - ref.begin());
+}
+
+bool test_searches(){
+    stl::he_list<int> empty;
+    if(empty.index_of(1) != 0 || empty.find(1) != empty.end() || empty.count(1) || empty.min_element() != empty.end())
+        return false;
+
+    for(std::size_t n : {std::size_t(1), std::size_t(255), std::size_t(256), std::size_t(257), std::size_t(5000)}){
+        std::vector<int> ints;
+        std::vector<double> reals;
+        std::vector<std::string> strs;
+        for(std::size_t i=0; i<n; ++i){
+            ints.push_back(int(de() % 1000) - 500);
+            reals.push_back(double(int(de() % 2000)) / 8);
+            strs.push_back(std::to_string(de() % 500));
+        }
+        std::vector<int> int_probes{ints.back(), ints.front(), 1000, -500};
+        std::vector<double> real_probes{reals.back(), 0.125, -1};
+        std::vector<std::string> str_probes{strs.back(), "x"};
+        if(!check_searches(stl::he_list<int>(ints.begin(), ints.end()), ints, int_probes) ||
+           !check_searches(stl::he_list<double>(reals.begin(), reals.end()), reals, real_probes) ||
+           !check_searches(stl::he_list<std::string>(strs.begin(), strs.end()), strs, str_probes))
+            return false;
+    }
+
+    //pending range updates are visible to the searches
+    stl::he_list<long long, stl::node_pool<long long>, sum_add> nums(std::size_t(1000), 1);
+    nums.apply(10, 20, 4);
+    if(nums.count(5) != 10 || nums.index_of(5) != 10 || nums.max_element() - nums.begin() != 10)
+        return false;
+
+    //ties and signed zeros resolve to the first element, as for the std algorithms
+    std::vector<double> zeros{3, 0.0, -0.0, 5, 5, 0.0};
+    return check_searches(stl::he_list<double>(zeros.begin(), zeros.end()), zeros, zeros);
+}
+
+bool test_stats(){
+    using counted = stl::he_list<int, stl::node_pool<int>, stl::he_list_plain, stl::he_list_counting>;
+    static_assert(sizeof(stl::he_list<int>) + sizeof(stl::he_list_stats) == sizeof(counted), "stats must cost nothing when disabled");
+
+    counted lst;
+    for(int i=0; i<5000; ++i)
+        lst.insert(de() % (lst.size() + 1), i);
+    auto st = lst.stats();
+    if(st.allocations != 5000 || st.frees || st.size != 5000)
+        return false;
+    if(!st.rotations_ll || !st.rotations_lr || !st.rotations_rr || !st.rotations_rl)
+        return false;
+    if(st.height < 13 || st.balance < 1 || st.balance > 1.45)
+        return false;
+
+    long long sum = 0;
+    auto before = st;
+    for(int i=0; i<100; ++i)
+        sum += lst[de() % lst.size()];
+    lst.erase(0);
+    lst.erase(10, 20);
+    st = lst.stats();
+    auto depth = st.search_depth_total - before.search_depth_total;
+    if(st.searches - before.searches != 101 || st.frees != 11 || st.search_depth_max > st.height ||
+       depth < 101 || depth > 101 * st.search_depth_max)
+        return false;
+
+    counted copied(lst);
+    if(copied.stats().allocations != lst.size())
+        return false;
+
+    //moves carry the counters over and leave the source at zero
+    auto counts = lst.stats();
+    counted moved(std::move(lst));
+    auto ms = moved.stats();
+    if(ms.allocations != counts.allocations || ms.frees != counts.frees || ms.searches != counts.searches ||
+       ms.rotations_ll != counts.rotations_ll || lst.stats().allocations || lst.stats().searches)
+        return false;
+    lst = std::move(moved);
+    if(lst.stats().allocations != counts.allocations || moved.stats().allocations)
+        return false;
+    lst.clear();
+    st = lst.stats();
+    if(st.frees != st.allocations || st.height || st.size)
+        return false;
+
+    //without the policy only the shape is reported
+    stl::he_list<int> plain(std::size_t(1000), 1);
+    auto ps = plain.stats();
+    return sum >= 0 && ps.size == 1000 && ps.height == 10 && ps.balance == 1 && !ps.allocations && !ps.rotations_rr;
+}
+
+template<typename List>
+bool build_throws(){
+    fragile::budget = 1 << 30;
+    std::vector<fragile> src(100, "a long string that does not fit into the small buffer");
+    fragile::alive = int(src.size());
+    for(int budget : {0, 1, 30, 63, 99}){
+        auto throws = [budget](auto op){
+            fragile::budget = budget;
+            try{
+                op();
+            }
+            catch(const std::runtime_error &){
+                fragile::budget = 1 << 30;
+                return true;
+            }
+            fragile::budget = 1 << 30;
+            return false;
+        };
+
+        //constructors, appends and inserts leave nothing behind but the old elements
+        if(!throws([&]{ List lst(src.begin(), src.end()); }) ||
+           !throws([&]{ List lst(std::size_t(100), src[0]); }) || fragile::alive != 100)
+            return false;
+
+        List lst(src.begin(), src.begin() + 10);
+        if(!throws([&]{ lst.append_range(src.begin(), src.end()); }) ||
+           !throws([&]{ lst.insert(5, src.begin(), src.end()); }) ||
+           lst.size() != 10 || fragile::alive != 110)
+            return false;
+    }
+    return true;
+}
+
+bool test_build_throws(){
+    return build_throws<stl::he_list<fragile>>() && build_throws<stl::he_list<fragile, std::allocator<fragile>>>();
+}
+
+//every parallel helper falls back to the calling thread when no thread can be started
+template<typename List>
+bool without_threads(){
+    std::vector<long long> ref(100000);
+    for(std::size_t i=0; i<ref.size(); ++i)
+        ref[i] = static_cast<long long>(i);
+
+    List src(ref.begin(), ref.end());
+    no_threads = true;
+    bool ok = true;
+    {
+        List copied(src);
+        copied.for_each([](long long &v){ v += 1; }, 8);
+        copied.transform([](long long v){ return v - 1; }, 8);
+        ok = ok && same(copied, ref);
+
+        const List &view = copied;
+        long long sum = 0;
+        view.for_each([&sum](const long long &v){ sum += v; }, 8);
+        ok = ok && sum == 4999950000LL && view.reduce(0LL, [](long long a, long long b){ return a + b; }, 8) == sum;
+
+        std::vector<long long> out(ref.size());
+        view.copy_to(out.begin(), 8);
+        ok = ok && out == ref;
+
+        auto frozen = copied.freeze(8);
+        ok = ok && frozen.size() == ref.size() && std::equal(frozen.begin(), frozen.end(), ref.begin());
+    }
+    no_threads = false;
+    return ok && same(src, ref);
+}
+
+bool test_no_threads(){
+    return without_threads<stl::he_list<long long>>() && without_threads<stl::he_list<long long, std::allocator<long long>>>();
+}
+
 int main() {
     stl::he_list<int> lst{3, 6, 9, 9, 10};
     print(lst);
@@ -29,4 +832,68 @@ int main() {
 
     lst.insert(2, 100);
     print(lst);
+
+    std::cout<<"--------------test allocators start--------------"<<std::endl;
+    std::cout<<(test_allocators()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test allocators end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test bulk build start--------------"<<std::endl;
+    std::cout<<(test_bulk_build()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test bulk build end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test split concat start--------------"<<std::endl;
+    std::cout<<(test_split_concat()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test split concat end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test bidirectional iterator start--------------"<<std::endl;
+    std::cout<<(test_bidirectional_iterator()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test bidirectional iterator end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test random access iterator start--------------"<<std::endl;
+    std::cout<<(test_random_access_iterator()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test random access iterator end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test cursor start--------------"<<std::endl;
+    std::cout<<(test_cursor()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test cursor end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test lazy range ops start--------------"<<std::endl;
+    std::cout<<(test_lazy_range_ops()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test lazy range ops end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test range query start--------------"<<std::endl;
+    std::cout<<(test_range_query()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test range query end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test parallel start--------------"<<std::endl;
+    std::cout<<(test_parallel()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test parallel end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test emplace insert range start--------------"<<std::endl;
+    std::cout<<(test_emplace_insert_range()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test emplace insert range end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test erase range clear start--------------"<<std::endl;
+    std::cout<<(test_erase_range_clear()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test erase range clear end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test freeze thaw start--------------"<<std::endl;
+    std::cout<<(test_freeze_thaw()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test freeze thaw end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test searches start--------------"<<std::endl;
+    std::cout<<(test_searches()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test searches end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test stats start--------------"<<std::endl;
+    std::cout<<(test_stats()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test stats end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test build throws start--------------"<<std::endl;
+    std::cout<<(test_build_throws()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test build throws end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test no threads start--------------"<<std::endl;
+    std::cout<<(test_no_threads()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test no threads end---------------"<<std::endl<<std::endl;
 }
@@ -2,6 +2,43 @@
 #include <random>
 #include <iostream>
 #include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+//every heap allocation of the test is counted
+std::size_t allocations = 0;
+
+void *operator new(std::size_t n){
+    ++allocations;
+    if(auto p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p)noexcept{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t)noexcept{
+    std::free(p);
+}
+
+void *operator new(std::size_t n, std::align_val_t al){
+    ++allocations;
+    if(auto p = std::aligned_alloc(std::size_t(al), (n + std::size_t(al) - 1) / std::size_t(al) * std::size_t(al)))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t)noexcept{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t)noexcept{
+    std::free(p);
+}
 
 namespace{
 
@@ -14,6 +51,59 @@ int sum(int a, int b){
 }
 
 
+//callable capturing N bytes, counting its live instances
+template<std::size_t N>
+struct capture{
+    static int alive;
+    long long data[N / sizeof(long long)];
+
+    capture(){
+        for(auto &d : data)
+            d = 1;
+        ++alive;
+    }
+    capture(const capture &rhs)noexcept{
+        for(std::size_t i=0; i<N / sizeof(long long); ++i)
+            data[i] = rhs.data[i];
+        ++alive;
+    }
+    ~capture(){ --alive; }
+
+    long long operator()(long long x){
+        data[0] += x;
+        return data[0];
+    }
+};
+
+template<std::size_t N>
+int capture<N>::alive = 0;
+
+struct alignas(32) aligned_callable{
+    int operator()(){
+        return int(reinterpret_cast<std::uintptr_t>(this) % 32);
+    }
+};
+
+struct throwing_move{
+    int val = 7;
+    throwing_move() = default;
+    throwing_move(const throwing_move &) = default;
+    throwing_move(throwing_move &&rhs):val(rhs.val) { }
+    int operator()(){ return val; }
+};
+
+//counts the copies and moves made of it
+struct counted{
+    static int copies, moves;
+    counted() = default;
+    counted(const counted &)noexcept{ ++copies; }
+    counted(counted &&)noexcept{ ++moves; }
+    int operator()(){ return 1; }
+};
+
+int counted::copies = 0;
+int counted::moves = 0;
+
 class Obj{
 public:
     virtual int multiple(const int &a, const int &b){
@@ -107,6 +197,209 @@ bool test_relations_ship(){
     return false;
 }
 
+bool test_small_buffer(){
+    //three pointers fit the default buffer, a fourth goes to the heap
+    auto before = allocations;
+    {
+        stl::function<long long(long long)> f(capture<24>{});
+        if(allocations != before || f(2) != 3 || f(2) != 5)
+            return false;
+        stl::function<long long(long long)> g(capture<32>{});
+        if(allocations != before + 1 || g(1) != 2)
+            return false;
+
+        //member function pointers and binds with one pointer fit as well
+        Obj obj;
+        before = allocations;
+        stl::function<int(Obj *, const int&, const int&)> m(&Obj::multiple);
+        stl::function<int(const int&, const int&)> b(std::bind(&Obj::multiple, &obj, std::placeholders::_1, std::placeholders::_2));
+        if(allocations != before || m(&obj, 3, 4) != 12 || b(5, 6) != 30)
+            return false;
+
+        //a larger buffer keeps 64 byte captures inline
+        stl::function<long long(long long), 64> big(capture<64>{});
+        auto copy = big;
+        if(allocations != before || copy(1) != 2 || big(1) != 2)
+            return false;
+    }
+    if(capture<24>::alive || capture<32>::alive || capture<64>::alive)
+        return false;
+
+    //over-aligned and throwing-move callables are kept on the heap
+    before = allocations;
+    stl::function<int()> a(aligned_callable{});
+    stl::function<int()> t(throwing_move{});
+    return allocations == before + 2 && a() == 0 && t() == 7 &&
+           sizeof(stl::function<int()>) == sizeof(void*) + stl::function_capacity;
+}
+
+bool test_copy_move(){
+    using fn = stl::function<long long(long long)>;
+    for(int heap=0; heap<2; ++heap){
+        fn f = heap ? fn(capture<48>{}) : fn(capture<16>{});
+        f(10);
+
+        //copies own their state, also when copied from a non-const lvalue
+        fn g(f);
+        fn h;
+        h = f;
+        if(g(1) != 12 || f(1) != 12 || h(5) != 16)
+            return false;
+
+        fn m(std::move(g));
+        if(g != nullptr || m == nullptr || m(1) != 13)
+            return false;
+        h = std::move(m);
+        if(m != nullptr || h(1) != 14)
+            return false;
+        h = h;
+        f = nullptr;
+        if(f != nullptr || h(1) != 15)
+            return false;
+    }
+    return !capture<16>::alive && !capture<48>::alive;
+}
+
+bool test_vtable(){
+    //one table pointer per function, the rest is the callable or its heap pointer
+    using fn0 = stl::version_0_1::function<int(int, int)>;
+    if(sizeof(fn0) != 2 * sizeof(void*) || sizeof(stl::function<int(), sizeof(void*)>) != 2 * sizeof(void*))
+        return false;
+
+    fn0 e;
+    fn0 f(sum);
+    fn0 g(f);
+    fn0 h(std::move(f));
+    e = g;
+    if(g(1, 2) != 3 || h(2, 3) != 5 || e(3, 4) != 7)
+        return false;
+    e = std::move(h);
+    if(e(4, 5) != 9)
+        return false;
+
+    //trivially copyable callables are moved as bytes, the others are relocated
+    int base = 10;
+    using fn = stl::function<long long(long long)>;
+    fn a([base](long long x){ return base + x; });
+    fn b(capture<16>{});
+    fn c(std::move(a));
+    fn d(std::move(b));
+    if(a || b || c(1) != 11 || d(1) != 2 || capture<16>::alive != 1)
+        return false;
+    a = std::move(d);
+    return !d && a(1) == 3 && capture<16>::alive == 1;
+}
+
+bool test_unique_function(){
+    using task = stl::unique_function<int(int)>;
+    static_assert(!std::is_copy_constructible<task>::value, "unique_function must be move-only.");
+    static_assert(sizeof(task) == sizeof(stl::function<int(int)>), "unique_function must be as small as function.");
+
+    //a move-only capture is stored inline, only the unique_ptr itself allocates
+    auto before = allocations;
+    task t([p = std::make_unique<int>(5)](int x){ return *p + x; });
+    if(allocations != before + 1 || t(1) != 6)
+        return false;
+
+    task u(std::move(t));
+    if(t != nullptr || u == nullptr || u(2) != 7)
+        return false;
+    t = std::move(u);
+    if(u || t(3) != 8)
+        return false;
+    t = nullptr;
+    if(t)
+        return false;
+
+    //move-only captures larger than the buffer go to the heap
+    std::unique_ptr<int> big[4] = {std::make_unique<int>(1), std::make_unique<int>(2), std::make_unique<int>(3), std::make_unique<int>(4)};
+    task h([big = std::move(big)](int x){ return *big[0] + *big[3] + x; });
+    task m = std::move(h);
+    if(h || m(1) != 6)
+        return false;
+
+    //an rvalue callable is moved into place, never copied
+    counted c;
+    counted::copies = counted::moves = 0;
+    stl::unique_function<int()> a(std::move(c));
+    stl::function<int()> f(std::move(c));
+    stl::function<int()> g(c);
+    return a() + f() + g() == 3 && counted::copies == 1 && counted::moves == 2;
+}
+
+int apply(stl::function_ref<int(int, int)> f, int a, int b){
+    return f(a, b);
+}
+
+bool test_function_ref(){
+    using ref = stl::function_ref<int(int, int)>;
+    static_assert(sizeof(ref) == 2 * sizeof(void*), "function_ref must be two words.");
+    static_assert(std::is_trivially_copyable<ref>::value, "function_ref must be trivially copyable.");
+
+    auto before = allocations;
+    int calls = 0;
+    auto counter = [&calls](int a, int b){ ++calls; return a * b; };
+    const auto twice = [](int a, int b){ return 2 * (a + b); };
+    int (*fp)(int, int) = sum;
+    if(apply(sum, 1, 2) != 3 || apply(fp, 2, 3) != 5 || apply(&Obj::minus, 5, 3) != 2 ||
+            apply(counter, 3, 4) != 12 || apply(twice, 1, 1) != 4 || calls != 1)
+        return false;
+
+    //temporaries live until the end of the full expression of the call
+    capture<32> c;
+    if(apply([c](int a, int b)mutable{ return int(c(a) + b); }, 1, 1) != 3)
+        return false;
+
+    //a copy refers to the same callable, the state is not duplicated
+    ref r(counter);
+    ref copy = r;
+    copy(1, 1);
+    r(1, 1);
+
+    //member function pointers are referred to like any other callable object
+    Obj obj;
+    auto mp = &Obj::multiple;
+    stl::function_ref<int(Obj *, const int&, const int&)> m(mp);
+    stl::function_ref<int(Obj &, const int&, const int&)> mr(mp);
+    stl::function<int(int)> f([](int x){ return x + 1; });
+    stl::function_ref<int(int)> fr(f);
+    return calls == 3 && m(&obj, 3, 4) == 12 && mr(obj, 2, 5) == 10 && fr(1) == 2 && allocations == before;
+}
+
+bool test_inplace_function(){
+    using fn = stl::inplace_function<long long(long long)>;
+    using big_fn = stl::inplace_function<long long(long long), 64, 32>;
+    static_assert(sizeof(fn) == sizeof(stl::function<long long(long long)>), "inplace_function must be as small as function.");
+    static_assert(std::is_nothrow_move_constructible<fn>::value && std::is_nothrow_move_assignable<fn>::value,
+                  "Moving an inplace_function must not throw.");
+
+    auto before = allocations;
+    {
+        fn f(capture<24>{});
+        fn g(f);
+        fn h;
+        h = f;
+        f(1);
+        if(f(1) != 3 || g(1) != 2 || h(2) != 3 || capture<24>::alive != 3)
+            return false;
+        fn m(std::move(g));
+        h = std::move(m);
+        if(g || m || h(1) != 3 || capture<24>::alive != 2)
+            return false;
+
+        //larger and over-aligned callables fit a larger buffer, still without allocating
+        big_fn b(capture<64>{});
+        big_fn a([al = aligned_callable{}](long long x)mutable{ return al() + x; });
+        big_fn c = b;
+        if(b(1) != 2 || c(2) != 3 || a(5) != 5)
+            return false;
+        b = nullptr;
+        if(b || capture<64>::alive != 1)
+            return false;
+    }
+    return allocations == before && !capture<24>::alive && !capture<64>::alive;
+}
+
 int main(int argc, char *argv[]){
     std::cout<<"--------------test global function start--------------"<<std::endl;
     std::cout<<(test_global_func()?"pass.":"wrong.")<<std::endl;
@@ -136,6 +429,30 @@ int main(int argc, char *argv[]){
     std::cout<<(test_relations_ship()?"pass.":"wrong")<<std::endl;
     std::cout<<"--------------test relations ship start--------------"<<std::endl<<std::endl;
 
+    std::cout<<"--------------test small buffer start--------------"<<std::endl;
+    std::cout<<(test_small_buffer()?"pass.":"wrong")<<std::endl;
+    std::cout<<"---------------test small buffer end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test copy move start--------------"<<std::endl;
+    std::cout<<(test_copy_move()?"pass.":"wrong")<<std::endl;
+    std::cout<<"---------------test copy move end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test vtable start--------------"<<std::endl;
+    std::cout<<(test_vtable()?"pass.":"wrong")<<std::endl;
+    std::cout<<"---------------test vtable end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test unique function start--------------"<<std::endl;
+    std::cout<<(test_unique_function()?"pass.":"wrong")<<std::endl;
+    std::cout<<"---------------test unique function end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test function ref start--------------"<<std::endl;
+    std::cout<<(test_function_ref()?"pass.":"wrong")<<std::endl;
+    std::cout<<"---------------test function ref end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test inplace function start--------------"<<std::endl;
+    std::cout<<(test_inplace_function()?"pass.":"wrong")<<std::endl;
+    std::cout<<"---------------test inplace function end---------------"<<std::endl<<std::endl;
+
     std::cout<<"All Pass!"<<std::endl;
     return 0;
 }
\ No newline at end of file
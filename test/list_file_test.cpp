@@ -0,0 +1,148 @@
+#include "list_file.hpp"
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace{
+
+std::default_random_engine de(20260301);
+
+const char *path = "list_file_test.bin";
+
+struct point{
+    double x, y;
+    int id;
+};
+
+struct sum{
+    using aggregate_type = long long;
+    static aggregate_type unit(){ return 0; }
+    static aggregate_type lift(long long val){ return val; }
+    static aggregate_type combine(aggregate_type a, aggregate_type b){ return a + b; }
+};
+
+template<typename List, typename V>
+bool same(const List &lst, const std::vector<V> &ref){
+    if(lst.size() != ref.size())
+        return false;
+
+    std::size_t i = 0;
+    for(auto it = lst.begin(); it != lst.end(); ++it, ++i){
+        if(*it != ref[i] || lst[i] != ref[i])
+            return false;
+    }
+    return i == ref.size();
+}
+
+}
+
+bool test_round_trip(){
+    for(std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(1000), std::size_t(300000)}){
+        stl::he_list<long long> lst;
+        std::vector<long long> ref;
+        for(std::size_t i=0; i<n; ++i){
+            auto pos = n > 1000 ? ref.size() : std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+            auto val = (long long)de();
+            lst.insert(pos, val);
+            ref.insert(ref.begin() + pos, val);
+        }
+        stl::save_list(lst, path);
+
+        auto loaded = stl::load_list<long long>(path);
+        auto pooled = stl::load_list<long long, std::allocator<long long>>(path);
+        auto summed = stl::load_list<long long, stl::node_pool<long long>, sum>(path);
+        if(!same(loaded, ref) || !same(pooled, ref) || !same(summed, ref))
+            return false;
+
+        long long total = 0;
+        for(auto v : ref)
+            total += v;
+        if(n && summed.query(0, n) != total)
+            return false;
+
+        loaded.push_back(7);
+        ref.push_back(7);
+        if(!same(loaded, ref))
+            return false;
+    }
+    return true;
+}
+
+bool test_mapped(){
+    stl::he_list<point> lst;
+    for(int i=0; i<5000; ++i)
+        lst.push_back(point{i * 0.5, -i * 0.25, i});
+    stl::save_list(lst, path);
+
+    stl::mapped_list<point> view(path);
+    if(view.size() != lst.size() || view.empty())
+        return false;
+    int i = 0;
+    for(auto &p : view){
+        if(p.id != i || p.x != i * 0.5 || view[i].y != -i * 0.25)
+            return false;
+        ++i;
+    }
+
+    stl::mapped_list<point> moved(std::move(view));
+    if(!view.empty() || moved.back().id != 4999 || moved.front().id != 0)
+        return false;
+
+    bool thrown = false;
+    try{
+        moved.at(5000);
+    }
+    catch(const std::runtime_error &){
+        thrown = true;
+    }
+    return thrown;
+}
+
+bool test_bad_file(){
+    stl::he_list<int> lst{1, 2, 3};
+    stl::save_list(lst, path);
+
+    int thrown = 0;
+    try{
+        stl::mapped_list<long long> wrong(path);
+    }
+    catch(const std::runtime_error &){
+        ++thrown;
+    }
+    try{
+        stl::load_list<int>("list_file_test.missing");
+    }
+    catch(const std::runtime_error &){
+        ++thrown;
+    }
+
+    //truncated payload
+    std::FILE *f = std::fopen(path, "wb");
+    auto h = stl::make_list_file_header<int>(100);
+    std::fwrite(&h, sizeof(h), 1, f);
+    std::fclose(f);
+    try{
+        stl::mapped_list<int> cut(path);
+    }
+    catch(const std::runtime_error &){
+        ++thrown;
+    }
+
+    std::remove(path);
+    return thrown == 3;
+}
+
+int main(){
+    std::cout<<"--------------test round trip start--------------"<<std::endl;
+    std::cout<<(test_round_trip()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test round trip end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test mapped start--------------"<<std::endl;
+    std::cout<<(test_mapped()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test mapped end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test bad file start--------------"<<std::endl;
+    std::cout<<(test_bad_file()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test bad file end---------------"<<std::endl<<std::endl;
+}
@@ -0,0 +1,208 @@
+#include "persistent_list.hpp"
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace{
+
+std::default_random_engine de(20260102);
+
+template<typename List, typename V>
+bool same(const List &lst, const std::vector<V> &ref){
+    if(lst.size() != ref.size())
+        return false;
+
+    std::size_t i = 0;
+    for(auto it = lst.begin(); it != lst.end(); ++it, ++i){
+        if(*it != ref[i] || lst[i] != ref[i])
+            return false;
+    }
+    return i == ref.size();
+}
+
+//string whose copies throw once a budget is used up, counting the live instances
+struct fragile{
+    static int alive, budget;
+    std::string val;
+
+    fragile(const char *v):val(v){ ++alive; }
+    fragile(const fragile &rhs):val(rhs.val){
+        if(!budget--)
+            throw std::runtime_error("copy failed");
+        ++alive;
+    }
+    ~fragile(){ --alive; }
+};
+
+int fragile::alive = 0;
+int fragile::budget = 1 << 30;
+
+}
+
+bool test_build(){
+    std::vector<int> ref{1, 2, 3, 4, 5, 6, 7};
+    stl::persistent_list<int> lst(ref.begin(), ref.end());
+    stl::persistent_list<int> filled(5, 9);
+    stl::persistent_list<int> listed{1, 2, 3};
+    return same(lst, ref) && same(filled, std::vector<int>(5, 9)) &&
+           same(listed, std::vector<int>{1, 2, 3}) && lst.front() == 1 && lst.back() == 7;
+}
+
+bool test_snapshots(){
+    stl::persistent_list<std::string> lst;
+    std::vector<std::string> ref;
+    std::vector<stl::persistent_list<std::string>> versions;
+    std::vector<std::vector<std::string>> refs;
+    for(int r=0; r<20000; ++r){
+        auto op = de() % 6;
+        if(ref.empty() || op < 3){
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+            auto val = std::to_string(de() % 1000);
+            lst.insert(pos, val);
+            ref.insert(ref.begin() + pos, val);
+        }
+        else if(op < 5){
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size()-1)(de);
+            lst.erase(pos);
+            ref.erase(ref.begin() + pos);
+        }
+        else{
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size()-1)(de);
+            auto val = std::to_string(de() % 1000);
+            lst.set(pos, val);
+            ref[pos] = val;
+        }
+
+        if(r % 500 == 0){
+            versions.push_back(lst);
+            refs.push_back(ref);
+        }
+    }
+    if(!same(lst, ref))
+        return false;
+
+    for(std::size_t i=0; i<versions.size(); ++i){
+        if(!same(versions[i], refs[i]))
+            return false;
+    }
+
+    //roll back to an old version and diverge from it
+    lst = versions[versions.size() / 2];
+    ref = refs[refs.size() / 2];
+    for(int r=0; r<1000; ++r){
+        lst.push_front(std::to_string(r));
+        ref.insert(ref.begin(), std::to_string(r));
+    }
+    if(!same(lst, ref) || !same(versions[versions.size() / 2], refs[refs.size() / 2]))
+        return false;
+
+    versions.clear();
+    while(!ref.empty()){
+        lst.pop_back();
+        ref.pop_back();
+    }
+    return lst.empty() && lst.begin() == lst.end();
+}
+
+bool test_build_throws(){
+    std::vector<fragile> src(100, "a long string that does not fit into the small buffer");
+    for(int budget : {0, 1, 30, 63, 99}){
+        for(int fill=0; fill<2; ++fill){
+            fragile::budget = budget;
+            try{
+                if(fill)
+                    stl::persistent_list<fragile> lst(100, src[0]);
+                else
+                    stl::persistent_list<fragile> lst(src.begin(), src.end());
+                return false;
+            }
+            catch(const std::runtime_error &){ }
+            fragile::budget = 1 << 30;
+            if(fragile::alive != 100)
+                return false;
+        }
+    }
+    return true;
+}
+
+template<typename List>
+bool same_vals(const List &lst, const std::vector<std::string> &ref){
+    if(lst.size() != ref.size())
+        return false;
+    std::size_t i = 0;
+    for(auto it = lst.begin(); it != lst.end(); ++it, ++i){
+        if(it->val != ref[i] || lst[i].val != ref[i])
+            return false;
+    }
+    return i == ref.size();
+}
+
+bool test_update_throws(){
+    //every node is shared with a snapshot, so inserts and erases copy their path
+    for(int budget=0; budget<40; ++budget){
+        for(int erase=0; erase<2; ++erase){
+            stl::persistent_list<fragile> lst;
+            std::vector<std::string> ref;
+            for(int i=0; i<200; ++i){
+                auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size())(de);
+                auto val = std::to_string(i);
+                lst.insert(pos, fragile(val.c_str()));
+                ref.insert(ref.begin() + pos, val);
+            }
+            auto snapshot = lst;
+            auto pos = std::uniform_int_distribution<std::size_t>(0, ref.size()-1)(de);
+            fragile x("x");
+
+            bool threw = false;
+            fragile::budget = budget;
+            try{
+                if(erase)
+                    lst.erase(pos);
+                else
+                    lst.insert(pos, x);
+            }
+            catch(const std::runtime_error &){
+                threw = true;
+            }
+            fragile::budget = 1 << 30;
+
+            //a failed update leaves the list as it was, a completed one is fully applied
+            auto expect = ref;
+            if(!threw){
+                if(erase)
+                    expect.erase(expect.begin() + pos);
+                else
+                    expect.insert(expect.begin() + pos, "x");
+            }
+            if(!same_vals(lst, expect) || !same_vals(snapshot, ref))
+                return false;
+            lst.push_back(x);
+            lst.erase(0);
+            expect.push_back("x");
+            expect.erase(expect.begin());
+            if(!same_vals(lst, expect))
+                return false;
+        }
+    }
+    return fragile::alive == 0;
+}
+
+int main(){
+    std::cout<<"--------------test build start--------------"<<std::endl;
+    std::cout<<(test_build()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test build end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test snapshots start--------------"<<std::endl;
+    std::cout<<(test_snapshots()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test snapshots end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test build throws start--------------"<<std::endl;
+    std::cout<<(test_build_throws()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test build throws end---------------"<<std::endl<<std::endl;
+
+    std::cout<<"--------------test update throws start--------------"<<std::endl;
+    std::cout<<(test_update_throws()?"pass.":"wrong.")<<std::endl;
+    std::cout<<"---------------test update throws end---------------"<<std::endl<<std::endl;
+}